@@ -0,0 +1,341 @@
+// Benchmark of the dictionary on synthetic word lists, results are written as JSON.
+// Build from this directory (there is no project file for the examples):
+//   g++ -std=c++17 -O2 -DNDEBUG -I.. bench.cpp ../word.cpp ../dict.cpp ../word_store.cpp ../file_loader.cpp
+//       ../prefix_index.cpp ../fuzzy_index.cpp ../perfect_hash.cpp ../bulk_writer.cpp ../collation.cpp -pthread -o dict_bench
+// Usage: dict_bench [--min entries] [--max entries] [--reps n] [--queries n] [--seed n] [--out file.json]
+// Sizes go from min to max in steps of 10x, 1000 to 10000000 unless given; 10000000 entries need about 4 GB of memory.
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+using namespace std;
+#include "word.h"
+#include "dict.h"
+
+namespace fs = std::filesystem;
+
+struct config
+{
+	size_t min_entries = 1000;
+	size_t max_entries = 10000000;
+	size_t reps = 5;
+	size_t queries = 200000;
+	unsigned seed = 2024;
+	string out_path = "dict_bench.json";
+};
+
+struct result
+{
+	string metric;
+	size_t entries;
+	size_t ops;		//operations timed by one run
+	size_t bytes;	//output of one run, 0 where it does not apply
+	vector<double> runs_ns;
+	double min_ns, median_ns;
+};
+
+static volatile size_t sink;	//keeps the timed loops from being optimized away
+//------------------------------------------------------
+
+// Letters drawn by their frequency in real text, lengths by the spread of dictionary headwords.
+class word_source
+{
+	vector<string> letters;
+	discrete_distribution<size_t> letter;
+	discrete_distribution<size_t> length;	//index = number of letters
+
+public:
+	word_source(vector<string> l, const vector<double>& letter_weights, const vector<double>& length_weights)
+		: letters(move(l)), letter(letter_weights.begin(), letter_weights.end()),
+		  length(length_weights.begin(), length_weights.end()) {}
+
+	string operator()(mt19937& engine)
+	{
+		string ret;
+		for (size_t i = max<size_t>(1, length(engine)); i > 0; i--)
+			ret += letters[letter(engine)];
+		return ret;
+	}
+};
+
+static word_source english()
+{
+	return { { "e","t","a","o","i","n","s","h","r","d","l","c","u","m","w","f","g","y","p","b","v","k","j","x","q","z" },
+			 { 127,91,82,75,70,67,63,61,60,43,40,28,28,24,24,22,20,20,19,15,10,8,2,2,1,1 },
+			 { 0,1,10,40,80,110,130,135,125,105,80,55,35,22,12,6,3 } };
+}
+
+// No q, v or x, so a Polish word ending in q is never in the vocabulary.
+static word_source polish()
+{
+	return { { "a","i","o","e","z","n","r","w","s","t","c","y","k","d","p","m","u","j","l","ł","b","g","ę","h","ą","ó","ż","ś","ć","f","ń","ź" },
+			 { 89,82,78,77,56,55,47,47,43,40,40,38,35,33,31,28,25,23,21,18,15,14,11,11,10,9,8,7,4,3,2,1 },
+			 { 0,0,3,15,45,80,110,130,135,125,105,80,55,35,22,12,6,3 } };
+}
+
+// Writes count pairs in the daily_words.txt format, about a quarter of the English terms get
+// more than one translation and a few are capitalized. Returns the pairs so queries can be drawn from them.
+static vector<pair<string, string>> generate(size_t count, const fs::path& file, mt19937& engine)
+{
+	auto eng = english();
+	auto pol = polish();
+	bernoulli_distribution another_translation(0.25);
+	bernoulli_distribution capitalized(0.05);
+
+	vector<pair<string, string>> ret;
+	ret.reserve(count);
+	string eng_term, text;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (i == 0 || !another_translation(engine))
+		{
+			eng_term = eng(engine);
+			if (capitalized(engine))
+				eng_term[0] = (char)toupper((unsigned char)eng_term[0]);
+		}
+		string pol_term = pol(engine);
+
+		text += eng_term;
+		text += ' ';
+		text += pol_term;
+		text += '\n';
+		ret.emplace_back(eng_term, pol_term);
+	}
+
+	ofstream out(file, ios::binary);
+	out.write(text.data(), text.size());
+	if (!out.good())
+		throw runtime_error("Cannot write " + file.string());
+
+	return ret;
+}
+//------------------------------------------------------
+
+template<class F>
+static double elapsed_ns(F&& f)
+{
+	auto start = chrono::steady_clock::now();
+	f();
+	return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+static result measure(string metric, size_t entries, size_t ops, const config& cfg, const function<void()>& run, size_t bytes = 0)
+{
+	result res{ move(metric), entries, ops, bytes, {}, 0, 0 };
+	for (size_t i = 0; i < cfg.reps; i++)
+		res.runs_ns.push_back(elapsed_ns(run));
+
+	auto sorted = res.runs_ns;
+	std::sort(sorted.begin(), sorted.end());
+	res.min_ns = sorted.front();
+	res.median_ns = sorted[sorted.size() / 2];
+	return res;
+}
+
+// Every metric for one vocabulary size.
+static void bench_size(size_t count, const config& cfg, vector<result>& results)
+{
+	mt19937 engine(cfg.seed + (unsigned)count);
+	const fs::path words_file = fs::temp_directory_path() / "dict_bench_words.txt";
+	const fs::path snapshot_file = fs::temp_directory_path() / "dict_bench.bin";
+	const fs::path dump_file = fs::temp_directory_path() / "dict_bench_dump.txt";
+
+	auto pairs = generate(count, words_file, engine);
+
+	dictionary S;
+	results.push_back(measure("load", count, count, cfg, [&]
+	{
+		S = dictionary();
+		if (!S.words_from_file(words_file.string()))
+			throw runtime_error("Cannot load " + words_file.string());
+	}));
+	const size_t entries = S.size();
+	results.back().entries = entries;
+
+	if (!S.save_words(snapshot_file.string()))
+		throw runtime_error("Cannot save " + snapshot_file.string());
+	results.push_back(measure("snapshot_load", entries, entries, cfg, [&]
+	{
+		if (!S.load_words(snapshot_file.string()))
+			throw runtime_error("Cannot load " + snapshot_file.string());
+	}));
+	S.build_indexes();
+
+	// hits are stored pairs, misses either a known English term with a foreign translation or an unknown pair
+	uniform_int_distribution<size_t> any_pair(0, pairs.size() - 1);
+	auto eng = english();
+	auto pol = polish();
+	vector<word> hits, misses;
+	for (size_t i = 0; i < cfg.queries; i++)
+	{
+		const auto& [eng_term, pol_term] = pairs[any_pair(engine)];
+		hits.emplace_back(eng_term, pol_term);
+		misses.emplace_back(i % 2 ? eng(engine) : eng_term, pol(engine) + "q");
+	}
+
+	results.push_back(measure("find_hit", entries, hits.size(), cfg, [&]
+	{
+		size_t found = 0;
+		for (const word& w : hits)
+			found += S.find_word(w);
+		if (found != hits.size())
+			throw runtime_error("find_word missed a stored pair");
+	}));
+	results.push_back(measure("find_miss", entries, misses.size(), cfg, [&]
+	{
+		size_t found = 0;
+		for (const word& w : misses)
+			found += S.find_word(w);
+		if (found != 0)
+			throw runtime_error("find_word found a pair that was never stored");
+	}));
+
+	results.push_back(measure("sort_toggle", entries, cfg.queries, cfg, [&]
+	{
+		for (size_t i = 0; i < cfg.queries; i++)
+		{
+			S.sort(Cmp::sort::POL_ANG);
+			S.sort(Cmp::sort::ANG_POL);
+		}
+	}));
+
+	// what test() does to pick a question, a uniform rank of the current order
+	S.sort(Cmp::sort::POL_ANG);
+	results.push_back(measure("select_uniform", entries, cfg.queries, cfg, [&]
+	{
+		uniform_int_distribution<size_t> rank(0, S.size() - 1);
+		size_t total = 0;
+		for (size_t i = 0; i < cfg.queries; i++)
+			total += S.at(rank(engine)).first.size();
+		sink = total;
+	}));
+
+	const size_t draws = max<size_t>(1, cfg.queries / 10);
+	results.push_back(measure("draw_10", entries, draws, cfg, [&]
+	{
+		size_t total = 0;
+		for (size_t i = 0; i < draws; i++)
+			total += S.draw(10, engine).front();
+		sink = total;
+	}));
+	S.sort(Cmp::sort::ANG_POL);
+
+	size_t dump_bytes = 0;
+	results.push_back(measure("dump", entries, entries, cfg, [&]
+	{
+		ofstream out(dump_file, ios::binary);
+		out << S;
+		dump_bytes = (size_t)out.tellp();
+	}));
+	results.back().bytes = dump_bytes;
+
+	for (auto [metric, format] : { pair{ "dump_tsv", dump_format::TSV }, pair{ "dump_csv", dump_format::CSV } })
+	{
+		results.push_back(measure(metric, entries, entries, cfg, [&, format = format]
+		{
+			ofstream out(dump_file, ios::binary);
+			S.dump(out, format);
+			dump_bytes = (size_t)out.tellp();
+		}));
+		results.back().bytes = dump_bytes;
+	}
+
+	fs::remove(words_file);
+	fs::remove(snapshot_file);
+	fs::remove(dump_file);
+}
+//------------------------------------------------------
+
+static void write_json(const vector<result>& results, const config& cfg)
+{
+	ofstream out(cfg.out_path);
+	if (!out.good())
+		throw runtime_error("Cannot open " + cfg.out_path);
+
+	out.precision(12);
+	out << "{\n";
+#ifdef __VERSION__
+	out << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+#endif
+	out << "  \"seed\": " << cfg.seed << ",\n";
+	out << "  \"timestamp\": " << chrono::duration_cast<chrono::seconds>(
+			chrono::system_clock::now().time_since_epoch()).count() << ",\n";
+	out << "  \"results\": [\n";
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const result& r = results[i];
+		out << "    { \"metric\": \"" << r.metric << "\", \"entries\": " << r.entries << ", \"ops\": " << r.ops
+			<< ", \"min_ns\": " << r.min_ns << ", \"median_ns\": " << r.median_ns
+			<< ", \"ns_per_op\": " << r.median_ns / (double)r.ops
+			<< ", \"ops_per_s\": " << (double)r.ops / (r.median_ns * 1e-9);
+		if (r.bytes > 0)
+			out << ", \"bytes\": " << r.bytes << ", \"bytes_per_s\": " << (double)r.bytes / (r.median_ns * 1e-9);
+		out << ", \"runs_ns\": [";
+		for (size_t j = 0; j < r.runs_ns.size(); j++)
+			out << (j ? ", " : "") << r.runs_ns[j];
+		out << "] }" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+
+	out << "  ]\n}\n";
+}
+
+static config parse_args(int argc, char** argv)
+{
+	config cfg;
+	for (int i = 1; i < argc; i += 2)
+	{
+		if (i + 1 >= argc)
+			throw invalid_argument(string("Missing value for ") + argv[i]);
+
+		if (!strcmp(argv[i], "--min")) cfg.min_entries = max<size_t>(1, stoul(argv[i + 1]));
+		else if (!strcmp(argv[i], "--max")) cfg.max_entries = stoul(argv[i + 1]);
+		else if (!strcmp(argv[i], "--reps")) cfg.reps = max<size_t>(1, stoul(argv[i + 1]));
+		else if (!strcmp(argv[i], "--queries")) cfg.queries = max<size_t>(1, stoul(argv[i + 1]));
+		else if (!strcmp(argv[i], "--seed")) cfg.seed = (unsigned)stoul(argv[i + 1]);
+		else if (!strcmp(argv[i], "--out")) cfg.out_path = argv[i + 1];
+		else throw invalid_argument(string("Unknown option ") + argv[i]);
+	}
+
+	return cfg;
+}
+
+int main(int argc, char** argv) try
+{
+	config cfg = parse_args(argc, argv);
+	vector<result> results;
+
+	printf("%-16s %10s %10s %14s %14s %12s %12s\n", "metric", "entries", "ops", "min [ms]", "median [ms]", "ns/op", "MB/s");
+	for (size_t count = cfg.min_entries; count <= cfg.max_entries; count *= 10)
+	{
+		size_t first = results.size();
+		bench_size(count, cfg, results);
+
+		for (size_t i = first; i < results.size(); i++)
+		{
+			const result& r = results[i];
+			printf("%-16s %10zu %10zu %14.3f %14.3f %12.1f", r.metric.c_str(), r.entries, r.ops,
+				   r.min_ns * 1e-6, r.median_ns * 1e-6, r.median_ns / (double)r.ops);
+			if (r.bytes > 0) printf(" %12.1f\n", (double)r.bytes / (r.median_ns * 1e-3));
+			else printf(" %12s\n", "-");
+		}
+		fflush(stdout);
+	}
+
+	write_json(results, cfg);
+	return 0;
+}
+catch (const exception& e)
+{
+	cerr << e.what() << endl;
+	return 1;
+}
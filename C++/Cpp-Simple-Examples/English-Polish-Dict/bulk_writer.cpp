@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+using namespace std;
+#include "bulk_writer.h"
+
+
+//------------------------------------------------------
+bulk_writer::bulk_writer(ostream& out, dump_format format, size_t capacity)
+	: out(out), format(format), buffer(max<size_t>(capacity, 4096))
+{
+}
+//------------------------------------------------------
+void bulk_writer::flush()
+{
+	if (used > 0)
+		out.write(buffer.data(), used);
+	used = 0;
+}
+//------------------------------------------------------
+//room for bytes more, a row longer than the whole buffer grows it
+char* bulk_writer::reserve(size_t bytes)
+{
+	if (used + bytes > buffer.size())
+	{
+		flush();
+		if (bytes > buffer.size())
+			buffer.resize(bytes);
+	}
+	return buffer.data() + used;
+}
+//------------------------------------------------------
+//whether term holds any of the four bytes, without a branch per byte since terms are short
+static bool has_any(string_view term, char a, char b, char c, char d)
+{
+	bool found = false;
+	for (char x : term)
+		found |= (x == a) | (x == b) | (x == c) | (x == d);
+	return found;
+}
+//------------------------------------------------------
+void bulk_writer::field(string_view term)
+{
+	//a separated term without special bytes is copied as it is
+	bool plain = format == dump_format::TSV ? !has_any(term, '\t', '\n', '\r', '\\')
+		: format == dump_format::CSV && !has_any(term, ',', '"', '\r', '\n');
+	if (plain)
+	{
+		memcpy(reserve(term.size()), term.data(), term.size());
+		used += term.size();
+		return;
+	}
+
+	switch (format)
+	{
+	case dump_format::FIXED:
+	{
+		size_t width = max(term.size(), column_width);
+		char* p = reserve(width);
+		memcpy(p, term.data(), term.size());
+		memset(p + term.size(), ' ', width - term.size());
+		used += width;
+		break;
+	}
+	case dump_format::TSV:
+	{
+		char* p = reserve(2 * term.size());
+		char* start = p;
+		for (char c : term)
+		{
+			const char* escaped = c == '\t' ? "\\t" : c == '\n' ? "\\n" : c == '\r' ? "\\r" : c == '\\' ? "\\\\" : nullptr;
+			if (escaped)
+			{
+				memcpy(p, escaped, 2);
+				p += 2;
+			}
+			else
+				*p++ = c;
+		}
+		used += p - start;
+		break;
+	}
+	case dump_format::CSV:
+	{
+		char* p = reserve(2 * term.size() + 2);
+		char* start = p;
+		*p++ = '"';
+		for (char c : term)
+		{
+			if (c == '"')
+				*p++ = '"';
+			*p++ = c;
+		}
+		*p++ = '"';
+		used += p - start;
+		break;
+	}
+	}
+}
+//------------------------------------------------------
+void bulk_writer::row(string_view eng, string_view pol)
+{
+	field(eng);
+	if (format != dump_format::FIXED)
+	{
+		*reserve(1) = format == dump_format::CSV ? ',' : '\t';
+		used++;
+	}
+	field(pol);
+	*reserve(1) = '\n';
+	used++;
+}
+//------------------------------------------------------
+void bulk_writer::row(size_t nr, string_view eng, string_view pol)
+{
+	char* p = reserve(21);
+	char* end = to_chars(p, p + 20, nr).ptr;
+	*end++ = format == dump_format::CSV ? ',' : format == dump_format::TSV ? '\t' : ' ';
+	used += end - p;
+	row(eng, pol);
+}
+//------------------------------------------------------
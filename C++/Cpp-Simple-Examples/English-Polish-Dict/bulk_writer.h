@@ -0,0 +1,40 @@
+#pragma once
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+using std::ostream;
+using std::string_view;
+using std::vector;
+
+
+enum class dump_format{FIXED,TSV,CSV};
+
+//formats dictionary rows into one preallocated buffer and hands it to the stream in large writes,
+//so there is no per-row formatting, locale or flush work
+//FIXED: both terms left aligned and padded to 30 bytes like setw(30), optionally numbered
+//TSV: tab separated, a tab, line break or backslash in a term is escaped as \t, \n, \r or \\ so every row stays one line
+//CSV: comma separated, a term with a comma, quote or line break is quoted as in RFC 4180
+class bulk_writer
+{
+	ostream& out;
+	dump_format format;
+	vector<char> buffer;
+	size_t used = 0;
+
+	char* reserve(size_t bytes);
+	void field(string_view term);
+
+public:
+	static constexpr size_t column_width = 30;
+
+	bulk_writer(ostream& out, dump_format format, size_t capacity = 1 << 20);
+	~bulk_writer() { flush(); }
+	bulk_writer(const bulk_writer&) = delete;
+	bulk_writer& operator=(const bulk_writer&) = delete;
+
+	void row(string_view eng, string_view pol);
+	//FIXED rows get "nr " in front, the other formats a first column with the number
+	void row(size_t nr, string_view eng, string_view pol);
+	void flush();
+};
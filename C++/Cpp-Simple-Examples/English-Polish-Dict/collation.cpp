@@ -0,0 +1,139 @@
+#include <cstdint>
+#include <cstring>
+using namespace std;
+#include "collation.h"
+
+
+//the alphabet in order, every letter with its capital
+static constexpr const char* letters[][2] = {
+	{ "a", "A" }, { "ą", "Ą" }, { "b", "B" }, { "c", "C" }, { "ć", "Ć" }, { "d", "D" }, { "e", "E" },
+	{ "ę", "Ę" }, { "f", "F" }, { "g", "G" }, { "h", "H" }, { "i", "I" }, { "j", "J" }, { "k", "K" },
+	{ "l", "L" }, { "ł", "Ł" }, { "m", "M" }, { "n", "N" }, { "ń", "Ń" }, { "o", "O" }, { "ó", "Ó" },
+	{ "p", "P" }, { "q", "Q" }, { "r", "R" }, { "s", "S" }, { "ś", "Ś" }, { "t", "T" }, { "u", "U" },
+	{ "v", "V" }, { "w", "W" }, { "x", "X" }, { "y", "Y" }, { "z", "Z" }, { "ź", "Ź" }, { "ż", "Ż" },
+};
+
+static constexpr unsigned char mark = 0xff;
+static constexpr unsigned char escape = 0xfe;
+
+//------------------------------------------------------
+// key of every ASCII byte and of every two-byte character: a Polish letter is its base letter and
+// marks times 0xff, base is 0 where a character is no letter; all of them start with 0xc3, 0xc4 or 0xc5
+struct collation_table
+{
+	struct letter
+	{
+		unsigned char base, marks;
+	};
+	unsigned char ascii[128];
+	letter two_byte[3][64];
+};
+//------------------------------------------------------
+static constexpr collation_table make_table()
+{
+	collation_table t{};
+	for (int c = 0; c < 128; c++)
+		t.ascii[c] = (unsigned char)c;
+
+	unsigned char base = 0;
+	unsigned char marks = 0;
+	for (const auto& spellings : letters)
+	{
+		auto small = (unsigned char)spellings[0][0];
+		if (spellings[0][1] == '\0')
+		{
+			base = small;
+			marks = 0;
+			t.ascii[(unsigned char)spellings[1][0]] = small;
+			continue;
+		}
+		marks++;
+		for (const char* spelling : spellings)
+			t.two_byte[(unsigned char)spelling[0] - 0xc3][(unsigned char)spelling[1] - 0x80] = { base, marks };
+	}
+	return t;
+}
+
+static constexpr collation_table table = make_table();
+
+//------------------------------------------------------
+char* write_collation_key(string_view term, char* out)
+{
+	auto s = (const unsigned char*)term.data();
+	auto end = s + term.size();
+
+	while (s < end)
+	{
+		unsigned char c = *s++;
+		if (c < 0x80)
+		{
+			*out++ = (char)table.ascii[c];
+			continue;
+		}
+		if (c >= 0xc3 && c <= 0xc5 && s < end && *s >= 0x80 && *s < 0xc0 && table.two_byte[c - 0xc3][*s - 0x80].base)
+		{
+			// both marks are written and only the needed ones kept, two bytes always have room for three
+			auto letter = table.two_byte[c - 0xc3][*s++ - 0x80];
+			out[0] = (char)letter.base;
+			out[1] = out[2] = (char)mark;
+			out += 1 + letter.marks;
+			continue;
+		}
+		*out++ = (char)escape;
+		*out++ = (char)c;
+	}
+	return out;
+}
+//------------------------------------------------------
+// eight bytes at a time: a byte with its high bit set is not ASCII, and adding 0x3f sets it for 'A' and above,
+// adding 0x25 for '[' and above; no byte carries into the next one while all of them are ASCII
+static bool ascii_without_capitals(uint64_t w)
+{
+	const uint64_t ones = 0x0101010101010101ull;
+	const uint64_t high = 0x80 * ones;
+	return ((w | ((w + 0x3f * ones) & ~(w + 0x25 * ones))) & high) == 0;
+}
+//------------------------------------------------------
+// read as whole words without a loop over the bytes: a shorter term as two overlapping halves of one word,
+// a longer one word by word, the last word overlapping the one before
+bool collates_as_itself(string_view term)
+{
+	const char* s = term.data();
+	size_t n = term.size();
+	if (n < 8)
+	{
+		uint32_t lo = 0, hi = 0;
+		if (n >= 4)
+		{
+			memcpy(&lo, s, 4);
+			memcpy(&hi, s + n - 4, 4);
+		}
+		else if (n > 0)
+			lo = (uint32_t)(unsigned char)s[0] | (uint32_t)(unsigned char)s[n / 2] << 8 | (uint32_t)(unsigned char)s[n - 1] << 16;
+		return ascii_without_capitals(lo | (uint64_t)hi << 32);
+	}
+
+	uint64_t w;
+	for (size_t i = 0; i + 8 < n; i += 8)
+	{
+		memcpy(&w, s + i, 8);
+		if (!ascii_without_capitals(w))
+			return false;
+	}
+	memcpy(&w, s + n - 8, 8);
+	return ascii_without_capitals(w);
+}
+//------------------------------------------------------
+vector<string> collation_letters_starting_with(string_view partial)
+{
+	vector<string> keys;
+	for (const auto& spellings : letters)
+		for (string_view spelling : spellings)
+			if (spelling.size() > partial.size() && spelling.substr(0, partial.size()) == partial)
+			{
+				keys.push_back(collation_key(spelling));
+				break;
+			}
+	return keys;
+}
+//------------------------------------------------------
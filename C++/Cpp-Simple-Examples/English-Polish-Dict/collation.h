@@ -0,0 +1,72 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using std::string;
+using std::unique_ptr;
+using std::string_view;
+using std::vector;
+
+
+//Collation keys in Polish alphabet order: a ą b c ć d e ę f g h i j k l ł m n ń o ó p q r s ś t u v w x y z ź ż,
+//capital and small letters being the same. Comparing two keys bytewise (memcmp) orders the terms,
+//and two terms have equal keys exactly when they differ only in case.
+//ASCII keeps its byte, capitals becoming small letters, so other ASCII keeps its place among the letters and
+//a term in ASCII without capitals is its own key. A Polish letter outside ASCII is its base letter followed by
+//0xff (ż by two), which puts it after every word going on with its base letter; 0xff starts no character, so a
+//key going on with it always lengthens the previous letter. Any other byte (other accented letters, other
+//scripts, broken UTF-8) becomes 0xfe followed by the byte, so those characters sort after the letters, in code point order.
+//A key is never longer than twice its term; out needs that much room, the end of the key is returned
+char* write_collation_key(string_view term, char* out);
+
+//whether the term is its own key
+bool collates_as_itself(string_view term);
+
+inline void append_collation_key(string& to, string_view term)
+{
+	size_t start = to.size();
+	to.resize(start + 2 * term.size());
+	to.resize(write_collation_key(term, &to[start]) - to.data());
+}
+
+inline string collation_key(string_view term)
+{
+	string key;
+	append_collation_key(key, term);
+	return key;
+}
+
+//the key of a term for one lookup: the term itself when it collates as itself, which then has to outlive it,
+//otherwise kept on the stack unless the term is long
+class lookup_key
+{
+	char local[64];
+	unique_ptr<char[]> heap;
+	string_view key;
+
+public:
+	explicit lookup_key(string_view term)
+	{
+		if (collates_as_itself(term))
+		{
+			key = term;
+			return;
+		}
+		char* out = local;
+		if (2 * term.size() > sizeof(local))
+		{
+			heap.reset(new char[2 * term.size()]);
+			out = heap.get();
+		}
+		key = string_view(out, write_collation_key(term, out) - out);
+	}
+	lookup_key(const lookup_key&) = delete;
+	lookup_key& operator=(const lookup_key&) = delete;
+
+	operator string_view() const { return key; }
+};
+
+//keys of the letters whose UTF-8 starts with the first bytes of a character still being typed, ascending
+vector<string> collation_letters_starting_with(string_view partial);
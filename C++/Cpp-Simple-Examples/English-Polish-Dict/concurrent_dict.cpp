@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <thread>
+using namespace std;
+#include "concurrent_dict.h"
+
+
+//------------------------------------------------------
+concurrent_dictionary::concurrent_dictionary(dictionary initial)
+{
+	// built after the move, which gives the words a new generation
+	auto base = make_shared<dictionary>(move(initial));
+	base->build_indexes();
+	auto first = make_unique<version>(version{ move(base), dictionary() });
+	first->added.build_indexes();
+	current.store(first.release());
+}
+//------------------------------------------------------
+// no reader may be active any more
+concurrent_dictionary::~concurrent_dictionary()
+{
+	for (const retired& r : retired_versions)
+		delete r.old;
+	delete current.load();
+}
+//------------------------------------------------------
+// claims a free slot and stores the current epoch in it. The claim is sequentially consistent with
+// the following load of current, so a writer that swapped the version out sees this reader
+size_t concurrent_dictionary::enter() const
+{
+	thread_local size_t preferred = hash<thread::id>()(this_thread::get_id());
+
+	for (size_t i = 0; ; i++)
+	{
+		size_t s = (preferred + i) % reader_slots;
+		uint64_t idle = 0;
+		if (slots[s].epoch.load(memory_order_relaxed) == 0
+			&& slots[s].epoch.compare_exchange_strong(idle, global_epoch.load()))
+		{
+			preferred = s;
+			return s;
+		}
+		if (i % reader_slots == reader_slots - 1)
+			this_thread::yield();
+	}
+}
+//------------------------------------------------------
+// a reader from an epoch some retired version waits for frees it on the way out. Freeing the slot is
+// sequentially consistent with the load after it, and the writer stores newest_retired before it sweeps,
+// so either the writer sees the slot free or this reader sees the version waiting
+void concurrent_dictionary::leave(size_t s) const
+{
+	uint64_t epoch = slots[s].epoch.load(memory_order_relaxed);
+	slots[s].epoch.store(0);
+	if (epoch <= newest_retired.load())
+		request_reclaim();
+}
+//------------------------------------------------------
+void concurrent_dictionary::publish(unique_ptr<version> next)
+{
+	next->added.build_indexes();
+
+	const version* old = current.exchange(next.release());
+	{
+		lock_guard<mutex> lock(retiring);
+		retired_versions.push_back({ old, global_epoch.fetch_add(1) });
+		newest_retired.store(retired_versions.back().epoch);
+	}
+	request_reclaim();
+}
+//------------------------------------------------------
+// the first thread to ask sweeps, and sweeps again for every request made meanwhile,
+// the others go on at once; no request is left without a sweep that starts after it
+void concurrent_dictionary::request_reclaim() const
+{
+	if (reclaim_requests.fetch_add(1) != 0)
+		return;
+
+	uint64_t served;
+	do
+	{
+		served = reclaim_requests.load();
+		reclaim();
+	} while (reclaim_requests.fetch_sub(served) != served);
+}
+//------------------------------------------------------
+// frees the versions retired before the oldest epoch a reader is still in. The slots are read under the lock,
+// after every retirement listed, and the versions are deleted after it is released
+void concurrent_dictionary::reclaim() const
+{
+	vector<const version*> freed;
+	{
+		lock_guard<mutex> lock(retiring);
+
+		uint64_t oldest = UINT64_MAX;
+		for (const slot& s : slots)
+		{
+			uint64_t e = s.epoch.load();
+			if (e != 0 && e < oldest)
+				oldest = e;
+		}
+
+		size_t kept = 0;
+		for (const retired& r : retired_versions)
+		{
+			if (r.epoch < oldest)
+				freed.push_back(r.old);
+			else
+				retired_versions[kept++] = r;
+		}
+		retired_versions.resize(kept);
+		newest_retired.store(kept ? retired_versions[kept - 1].epoch : 0);
+	}
+
+	for (const version* v : freed)
+		delete v;
+}
+//------------------------------------------------------
+size_t concurrent_dictionary::size() const
+{
+	return read([](const version& v) { return v.base->size() + v.added.size(); });
+}
+//------------------------------------------------------
+bool concurrent_dictionary::find_word(const word& s) const
+{
+	return read([&](const version& v) { return v.base->find_word(s) || v.added.find_word(s); });
+}
+//------------------------------------------------------
+// both parts complete in collation order and are merged; a spelling found in both is taken once
+vector<string> concurrent_dictionary::complete(string_view prefix, size_t k, lang side) const
+{
+	return read([&](const version& v) {
+		vector<string_view> from_base = v.base->complete(prefix, k, side);
+		vector<string_view> from_added = v.added.complete(prefix, k, side);
+
+		vector<string> out;
+		size_t i = 0, j = 0;
+		while (out.size() < k && (i < from_base.size() || j < from_added.size()))
+		{
+			if (j == from_added.size())
+				out.emplace_back(from_base[i++]);
+			else if (i == from_base.size())
+				out.emplace_back(from_added[j++]);
+			else if (from_base[i] == from_added[j])
+			{
+				out.emplace_back(from_base[i++]);
+				j++;
+			}
+			else if (collation_key(from_base[i]) <= collation_key(from_added[j]))
+				out.emplace_back(from_base[i++]);
+			else
+				out.emplace_back(from_added[j++]);
+		}
+		return out;
+		});
+}
+//------------------------------------------------------
+// the added words are copied and indexed with every batch, the base only once they outgrow twice its square
+// root: a word then costs about as much in copies of the added ones as in its share of rebuilding the base
+void concurrent_dictionary::insert(const vector<word>& batch)
+{
+	lock_guard<mutex> lock(writer);
+	const version* now = current.load();
+
+	vector<word> fresh;
+	for (const word& s : batch)
+		if (!now->base->find_word(s))
+			fresh.push_back(s);
+	if (fresh.empty())
+		return;
+
+	auto next = make_unique<version>(version{ now->base, now->added });
+	next->added.insert(fresh);
+	if (next->added.size() > max(min_added, 2 * (size_t)sqrt((double)next->base->size())))
+	{
+		auto base = make_shared<dictionary>(*next->base);
+		base->insert(next->added);
+		base->build_indexes();
+		next->base = move(base);
+		next->added = dictionary();
+	}
+	publish(move(next));
+}
+//------------------------------------------------------
+// a whole file goes straight into a new base, together with the words added so far
+bool concurrent_dictionary::words_from_file(string file_name)
+{
+	lock_guard<mutex> lock(writer);
+	const version* now = current.load();
+
+	auto base = make_shared<dictionary>(*now->base);
+	if (!base->words_from_file(file_name))
+		return false;
+	if (now->added.size() != 0)
+		base->insert(now->added);
+	base->build_indexes();
+
+	publish(make_unique<version>(version{ move(base), dictionary() }));
+	return true;
+}
+//------------------------------------------------------
@@ -0,0 +1,99 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "dict.h"
+
+using std::atomic;
+using std::mutex;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+
+//dictionary shared by many reader threads and a few writers.
+//Readers take no lock: they announce the epoch they start in, then read whichever version is current.
+//A version is a large base, shared with the versions before it, and the few words added since. A writer copies
+//only those, merges its batch into them, indexes them and publishes the result with one pointer swap; once they
+//outgrow the base's square root they are merged into a new base. The old version is freed by the last reader
+//that could still see it, or by the writer when there is none.
+class concurrent_dictionary
+{
+	static const size_t reader_slots = 128;	//more readers at the same moment wait for a free slot
+	static constexpr size_t min_added = 256;	//words added before the base is rebuilt, at least
+
+	struct alignas(64) slot
+	{
+		atomic<uint64_t> epoch{ 0 };	//0 while no reader holds the slot
+	};
+
+	//every index of both parts is built before the version is published
+	struct version
+	{
+		shared_ptr<const dictionary> base;
+		dictionary added;	//no pair of it is in base
+	};
+
+	struct retired
+	{
+		const version* old;
+		uint64_t epoch;	//readers that announced this epoch or an earlier one may still use it
+	};
+
+	atomic<const version*> current;
+	atomic<uint64_t> global_epoch{ 1 };
+	mutable slot slots[reader_slots];
+
+	mutex writer;
+	mutable mutex retiring;		//guards retired_versions, held only to add to it or sweep it
+	mutable vector<retired> retired_versions;
+	mutable atomic<uint64_t> newest_retired{ 0 };	//epoch of the last version waiting to be freed, 0 if none
+	mutable atomic<uint64_t> reclaim_requests{ 0 };	//asked for and not yet served, one thread serves them all
+
+	size_t enter() const;
+	void leave(size_t s) const;
+	void publish(std::unique_ptr<version> next);
+	void request_reclaim() const;
+	void reclaim() const;
+
+	//pins the current version for the lifetime of the guard
+	class reader_guard
+	{
+		const concurrent_dictionary& owner;
+		size_t s;
+
+	public:
+		const version* pinned;
+
+		explicit reader_guard(const concurrent_dictionary& owner)
+			: owner(owner), s(owner.enter()), pinned(owner.current.load()) {}
+		~reader_guard() { owner.leave(s); }
+		reader_guard(const reader_guard&) = delete;
+		reader_guard& operator=(const reader_guard&) = delete;
+	};
+
+	//runs f(const version&) on the current version, nothing taken from it may outlive the call
+	template<class F>
+	auto read(F&& f) const
+	{
+		reader_guard guard(*this);
+		return f(*guard.pinned);
+	}
+
+public:
+	explicit concurrent_dictionary(dictionary initial = {});
+	~concurrent_dictionary();
+	concurrent_dictionary(const concurrent_dictionary&) = delete;
+	concurrent_dictionary& operator=(const concurrent_dictionary&) = delete;
+
+	size_t size() const;
+	bool find_word(const word& s) const;
+	//like dictionary::complete, but copies the terms out of the version
+	vector<string> complete(string_view prefix, size_t k, lang side) const;
+
+	//both publish a new version; writers are serialized, readers are never blocked
+	void insert(const vector<word>& batch);
+	bool words_from_file(string file_name);
+};
@@ -1,8 +1,16 @@
 #pragma once
+#include <string_view>
+#include <utility>
 #include "word.h"
 
+using std::string_view;
+using std::pair;
 
-//functor - specifies the sorting criterion in the dictionary
+using term_pair = pair<string_view, string_view>;	//(eng, pol) without owning the characters
+
+
+//functor - specifies the sorting criterion in the dictionary.
+//Pairs are compared bytewise as given, the dictionary passes their collation keys
 class Cmp {
 
 public:
@@ -15,18 +23,18 @@ public:
 	Cmp(Cmp::sort criterion=Cmp::sort::ANG_POL): criterion{ criterion } {}
 	Cmp::sort getCriterion() const { return criterion; }
 
-	bool operator()(const word& s1, const word& s2) const
+	bool operator()(const term_pair& s1, const term_pair& s2) const
 	{
 		if (criterion == Cmp::sort::POL_ANG)
 		{
-			if (s1.pol < s2.pol)  return true;
-			if (s1.pol == s2.pol && s1.eng < s2.eng) return true;
+			if (s1.second < s2.second)  return true;
+			if (s1.second == s2.second && s1.first < s2.first) return true;
 			return false;
 		}
 		else
 		{
-			if (s1.eng < s2.eng)  return true;
-			if (s1.eng == s2.eng && s1.pol < s2.pol) return true;
+			if (s1.first < s2.first)  return true;
+			if (s1.first == s2.first && s1.second < s2.second) return true;
 			return false;
 		}
 	}
@@ -1,41 +1,44 @@
-#include <iomanip>
-#include <fstream>
 #include <algorithm>
+#include <random>
+#include <unordered_set>
 using namespace std;
 #include "dict.h"
 #include "word.h"
 #include "criteria.h"
+#include "file_loader.h"
 
 
 //------------------------------------------------------
 dictionary::dictionary(initializer_list<word> init)
 {
-	S.insert(init);
+	vector<term_pair> pairs;
+	for (const word& s : init)
+		pairs.emplace_back(s.eng, s.pol);
+	store.build(move(pairs));
 
 }
 //------------------------------------------------------
 bool  dictionary::words_from_file(string file_name)
 {
-	ifstream in;
-	word s;
-	in.open(file_name);
-	if (!in.good())
+	mapped_file in;
+	if (!in.open(file_name))
 	{
 		cout << "File reading error\n";
 		return false;
 	}
-	while (!in.eof())
-	{
-		in >> s;
-		S.insert(s);
-	}
+
+	// the pairs point into the mapping, build copies them into the store before it is closed
+	store.build(read_pairs(in.contents()));
+	// built with the load, not on the first lookup
+	update_hashes();
 
 	return true;
 }
 //------------------------------------------------------
+// only switches the view, both orders are always kept up to date
 void dictionary::sort(Cmp::sort how)
 {
-	S = set<word, Cmp>(how);
+	order = how;
 }
 
 //------------------------------------------------------
@@ -43,56 +46,312 @@ void dictionary::insert()
 {
 	word s;
 	cin >> s;
-	S.insert(s);
+	store.insert(s.eng, s.pol);
+
+}
+//------------------------------------------------------
+void dictionary::insert(const vector<word>& batch)
+{
+	vector<term_pair> pairs;
+	pairs.reserve(batch.size());
+	for (const word& s : batch)
+		pairs.emplace_back(s.eng, s.pol);
+	store.build(move(pairs));
+}
+//------------------------------------------------------
+void dictionary::insert(const dictionary& other)
+{
+	vector<term_pair> pairs;
+	pairs.reserve(other.size());
+	for (size_t i = 0; i < other.size(); i++)
+		pairs.push_back(other.store.terms(other.store.at(Cmp::sort::ANG_POL, i)));
+	store.build(move(pairs));
+}
+//------------------------------------------------------
+bool dictionary::find_word(const word& s) const
+{
+	return contains(s.eng, s.pol);
+}
+//------------------------------------------------------
+// the hashes are taken over collation keys, so a word differing in case finds its entry
+static uint64_t pair_key(string_view eng_key, string_view pol_key)
+{
+	return hash_text(pol_key, hash_text(eng_key));
+}
+//------------------------------------------------------
+void dictionary::update_hashes() const
+{
+	if (hashes_version == store.version())
+		return;
+
+	size_t n = store.size();
+	vector<uint64_t> keys(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		term_pair k = store.keys(store.at(Cmp::sort::ANG_POL, i));
+		keys[i] = pair_key(k.first, k.second);
+	}
+
+	vector<uint32_t> firsts;
+	vector<uint64_t> eng_keys;
+	for (size_t i = 0; i < n; i++)
+	{
+		string_view eng_key = store.eng_key(store.at(Cmp::sort::ANG_POL, i));
+		if (i == 0 || eng_key != store.eng_key(store.at(Cmp::sort::ANG_POL, i - 1)))
+		{
+			firsts.push_back((uint32_t)i);
+			eng_keys.push_back(hash_text(eng_key));
+		}
+	}
+
+	pair_hash.build(keys);
+	eng_hash.build(eng_keys);
+
+	// a slot taken twice means two different keys with the same hash
+	hash_collisions = false;
+	pair_slots.assign(pair_hash.size(), UINT32_MAX);
+	for (size_t i = 0; i < n; i++)
+	{
+		uint32_t& slot = pair_slots[pair_hash.lookup(keys[i])];
+		hash_collisions |= slot != UINT32_MAX;
+		slot = (uint32_t)i;
+	}
+
+	eng_slots.assign(eng_hash.size(), UINT32_MAX);
+	for (size_t i = 0; i < firsts.size(); i++)
+	{
+		uint32_t& slot = eng_slots[eng_hash.lookup(eng_keys[i])];
+		hash_collisions |= slot != UINT32_MAX;
+		slot = firsts[i];
+	}
+
+	hashes_version = store.version();
+}
+//------------------------------------------------------
+// one hash and one probe; the entry found is compared since a word that is not there lands in some slot too
+bool dictionary::contains(string_view eng, string_view pol) const
+{
+	update_hashes();
+
+	lookup_key eng_key(eng), pol_key(pol);
+	uint64_t slot = pair_hash.lookup(pair_key(eng_key, pol_key));
+	if (slot < pair_slots.size() && pair_slots[slot] != UINT32_MAX
+		&& store.keys(store.at(Cmp::sort::ANG_POL, pair_slots[slot])) == term_pair(eng_key, pol_key))
+		return true;
 
+	return hash_collisions && store.contains(eng, pol);
+}
+//------------------------------------------------------
+vector<string_view> dictionary::translations(string_view eng) const
+{
+	update_hashes();
+
+	lookup_key key(eng);
+	size_t first = store.size();
+	uint64_t slot = eng_hash.lookup(hash_text(key));
+	if (slot < eng_slots.size() && eng_slots[slot] != UINT32_MAX && store.eng_key(store.at(Cmp::sort::ANG_POL, eng_slots[slot])) == key)
+		first = eng_slots[slot];
+	else if (hash_collisions)
+	{
+		// the entries of a term are neighbours in ANG_POL order, the first is found by binary search
+		size_t lo = 0, hi = store.size();
+		while (lo < hi)
+		{
+			size_t mid = (lo + hi) / 2;
+			if (store.eng_key(store.at(Cmp::sort::ANG_POL, mid)) < key)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		first = lo;
+	}
+
+	vector<string_view> out;
+	for (size_t i = first; i < store.size() && store.eng_key(store.at(Cmp::sort::ANG_POL, i)) == key; i++)
+		out.push_back(store.pol(store.at(Cmp::sort::ANG_POL, i)));
+	return out;
+}
+//------------------------------------------------------
+// rand() stops at RAND_MAX, which can be as low as 32767
+static mt19937& random_engine()
+{
+	static thread_local mt19937 engine(random_device{}());
+	return engine;
 }
 //------------------------------------------------------
-bool dictionary::find_word(word s) const
+term_pair dictionary::at(size_t rank) const
 {
-	auto it = S.find(s);
-	return it != S.end();
+	return store.terms(store.at(order, rank));
+}
+//------------------------------------------------------
+// Floyd's sampling: one random number per drawn rank, no matter how large the dictionary is
+vector<size_t> dictionary::draw(size_t k, mt19937& engine) const
+{
+	size_t n = store.size();
+	k = min(k, n);
+
+	vector<size_t> ranks;
+	ranks.reserve(k);
+
+	// a bitmap once it is not much larger than the set would be
+	bool dense = k >= n / 64;
+	vector<bool> taken(dense ? n : 0);
+	unordered_set<size_t> chosen(dense ? 0 : 2 * k);
+
+	for (size_t j = n - k; j < n; j++)
+	{
+		size_t t = uniform_int_distribution<size_t>(0, j)(engine);
+		bool seen = dense ? (bool)taken[t] : chosen.count(t) > 0;
+		size_t pick = seen ? j : t;
+
+		if (dense)
+			taken[pick] = true;
+		else
+			chosen.insert(pick);
+		ranks.push_back(pick);
+	}
+
+	// the picks are a uniform set but not in uniform order
+	shuffle(ranks.begin(), ranks.end(), engine);
+	return ranks;
+}
+//------------------------------------------------------
+void dictionary::update_prefixes() const
+{
+	if (prefixes_version != store.version())
+	{
+		prefixes[(int)lang::ENG].build(store.terms_of(lang::ENG));
+		prefixes[(int)lang::POL].build(store.terms_of(lang::POL));
+		prefixes_version = store.version();
+	}
+}
+//------------------------------------------------------
+void dictionary::update_similar() const
+{
+	if (similar_version != store.version())
+	{
+		// the distance is taken between spellings, the keys are not needed
+		for (lang side : { lang::ENG, lang::POL })
+		{
+			vector<string_view> terms;
+			for (const auto& t : store.terms_of(side))
+				terms.push_back(t.first);
+			similar[(int)side].build(move(terms));
+		}
+		similar_version = store.version();
+	}
+}
+//------------------------------------------------------
+void dictionary::build_indexes() const
+{
+	update_prefixes();
+	update_similar();
+	update_hashes();
+}
+//------------------------------------------------------
+vector<string_view> dictionary::complete(string_view prefix, size_t k, lang side) const
+{
+	update_prefixes();
+	return prefixes[(int)side].complete(prefix, k);
+}
+//------------------------------------------------------
+vector<pair<string_view, unsigned>> dictionary::find_similar(string_view query, unsigned k, lang side) const
+{
+	update_similar();
+	return similar[(int)side].find(query, k);
 }
 //------------------------------------------------------
 void dictionary::test() const
 {
-	int los = rand() % S.size();
-	auto it = S.begin();
-	advance(it, los);
-	cout << "Chosen: " << los + 1 << ". Polish Part: " << it->pol << '\n';
+	if (store.empty())
+	{
+		cout << "Dictionary is empty\n";
+		return;
+	}
+
+	size_t los = uniform_int_distribution<size_t>(0, store.size() - 1)(random_engine());
+	term_pair chosen = at(los);
+	cout << "Chosen: " << los + 1 << ". Polish Part: " << chosen.second << '\n';
 	cout << "Write the word in eng: ";
 	string eng;
 	cin >> eng;
-	if (find_word(word(eng, it->pol)))
+	// other translations of the same Polish word count too
+	if (eng == chosen.first || contains(eng, chosen.second))
 	{
 		cout << "Good Answer!\n";
 	}
 	else
 	{
 		cout << "Wrong Answer\n";
+
+		// a typo of a correct translation gets a hint
+		for (const auto& close : find_similar(eng, 2, lang::ENG))
+			if (contains(close.first, chosen.second))
+			{
+				cout << "Almost! Did you mean: " << close.first << "?\n";
+				break;
+			}
 	}
 
 }
 //------------------------------------------------------
-bool dictionary::save_words() const
+// the perfect hashes go into the snapshot's appendix, a loaded snapshot answers lookups without building them
+bool dictionary::save_words(string file_name) const
+{
+	update_hashes();
+
+	string appendix;
+	pair_hash.save(appendix);
+	eng_hash.save(appendix);
+	put_array(appendix, pair_slots);
+	put_array(appendix, eng_slots);
+	put_array(appendix, vector<uint8_t>{ hash_collisions });
+	return store.save(file_name, appendix);
+}
+//------------------------------------------------------
+bool dictionary::load_words(string file_name)
 {
+	if (!store.load(file_name))
+		return false;
 
+	// every slot has to hold a rank in range, a damaged appendix is only a reason to build the hashes again
+	string_view appendix = store.appendix();
+	vector<uint8_t> collisions;
+	bool good = pair_hash.load(appendix) && eng_hash.load(appendix)
+		&& take_array(appendix, pair_slots) && take_array(appendix, eng_slots) && take_array(appendix, collisions)
+		&& pair_slots.size() == pair_hash.size() && eng_slots.size() == eng_hash.size() && collisions.size() == 1;
+	for (const vector<uint32_t>* slots : { &pair_slots, &eng_slots })
+		good = good && all_of(slots->begin(), slots->end(), [&](uint32_t r) { return r == UINT32_MAX || r < store.size(); });
 
+	if (good)
+	{
+		hash_collisions = collisions[0] != 0;
+		hashes_version = store.version();
+	}
+	else
+		update_hashes();
 	return true;
 }
 //------------------------------------------------------
+void dictionary::dump(ostream& out, dump_format format, bool numbered) const
+{
+	bulk_writer writer(out, format);
+	for (size_t rank = 0; rank < store.size(); rank++)
+	{
+		const entry& e = store.at(order, rank);
+		if (numbered)
+			writer.row(rank + 1, store.eng(e), store.pol(e));
+		else
+			writer.row(store.eng(e), store.pol(e));
+	}
+	writer.flush();
+	out.flush();
+}
+//------------------------------------------------------
 ostream& operator<<(ostream& out, const dictionary& S)
 {
-	for_each(S.S.begin(), S.S.end(), [&out, nr=1](const word& s) mutable -> bool {
-		if (&out == &cout)
-		{
-			cout << nr << " ";
-			nr++;
-		}
-		out << s;
-		return true;
-		});
-	
-
+	//the menu listing is numbered
+	S.dump(out, dump_format::FIXED, &out == &cout);
 	return out;
 }
-//------------------------------------------------------
\ No newline at end of file
+//------------------------------------------------------
@@ -1,33 +1,87 @@
 #pragma once
 
-#include <set>
+#include <random>
 #include "dict.h"
 #include "criteria.h"
+#include "word_store.h"
+#include "prefix_index.h"
+#include "fuzzy_index.h"
+#include "perfect_hash.h"
+#include "bulk_writer.h"
 
-using std::set;
+using std::mt19937;
 
 
 class dictionary
 {
-	set<word,Cmp> S;
+	word_store store;	//both orders are always kept up to date
+	Cmp::sort order = Cmp::sort::ANG_POL;	//the view used for printing and test
+
+	//built on first use after the store changed, the hashes already with a load
+	mutable prefix_index prefixes[2];
+	mutable uint64_t prefixes_version = UINT64_MAX;
+	mutable fuzzy_index similar[2];
+	mutable uint64_t similar_version = UINT64_MAX;
+
+	mutable perfect_hash pair_hash, eng_hash;
+	mutable vector<uint32_t> pair_slots;	//ANG_POL rank of the entry in every slot of pair_hash
+	mutable vector<uint32_t> eng_slots;		//ANG_POL rank of the first entry of every English term
+	mutable bool hash_collisions = false;	//two keys share a 64-bit hash, a miss is confirmed by binary search
+	mutable uint64_t hashes_version = UINT64_MAX;
+
+	void update_prefixes() const;
+	void update_similar() const;
+	void update_hashes() const;
+	bool contains(string_view eng, string_view pol) const;
 
 public:
 	dictionary() = default;
 	dictionary(initializer_list<word> init);
+	//copies the words only, the lookup indexes are built again when needed
+	dictionary(const dictionary& other) : store(other.store), order(other.order) {}
+	dictionary& operator=(const dictionary& other) { store = other.store; order = other.order; return *this; }
+	dictionary(dictionary&&) = default;
+	dictionary& operator=(dictionary&&) = default;
 
 	bool words_from_file(string nazwa_pliku);
 
 	void sort(Cmp::sort jak);
 
 	void insert();
+	//adds a whole batch with one merge
+	void insert(const vector<word>& batch);
+	//adds every word of another dictionary with one merge
+	void insert(const dictionary& other);
 
-	bool find_word(word s) const;
+	//whether the pair is stored, ignoring case
+	bool find_word(const word& s) const;
+	//every Polish translation of an English term, whatever its case
+	vector<string_view> translations(string_view eng) const;
 	void test() const;
 
-	bool save_words() const;
+	size_t size() const { return store.size(); }
+	//entry at a rank of the current order, O(1)
+	term_pair at(size_t rank) const;
+	//k distinct random ranks (all of them if k >= size), in random order
+	vector<size_t> draw(size_t k, mt19937& engine) const;
+
+	//up to k terms of one language starting with prefix (ignoring case), in collation order
+	vector<string_view> complete(string_view prefix, size_t k, lang side) const;
+	//terms of one language within edit distance k of query, closest first
+	vector<pair<string_view, unsigned>> find_similar(string_view query, unsigned k, lang side) const;
+	//builds every lookup index now instead of on first use; afterwards the const
+	//members can be called from several threads as long as nothing changes
+	void build_indexes() const;
+
+	//every entry in the current order, formatted in one buffer and written in large chunks;
+	//numbered adds the menu listing numbers
+	void dump(ostream& out, dump_format format = dump_format::FIXED, bool numbered = false) const;
+
+	bool save_words(string file_name = "dictionary.bin") const;
+	//replaces the contents with a snapshot written by save_words, mapped read-only until changed
+	bool load_words(string file_name = "dictionary.bin");
 	
 	friend ostream& operator<<(ostream& out, const dictionary& S);
 
 
 };
-
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <thread>
+using namespace std;
+#include "file_loader.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DICT_SSE2
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+//------------------------------------------------------
+mapped_file::~mapped_file()
+{
+	close();
+}
+//------------------------------------------------------
+bool mapped_file::open(const string& file_name)
+{
+	close();
+#ifdef _WIN32
+	ifstream in(file_name, ios::binary);
+	if (!in.good())
+		return false;
+	contents_copy.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+	data = contents_copy.data();
+	length = contents_copy.size();
+	return true;
+#else
+	int fd = ::open(file_name.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	length = (size_t)st.st_size;
+	if (length > 0)
+	{
+		void* map = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map == MAP_FAILED)
+		{
+			::close(fd);
+			length = 0;
+			return false;
+		}
+		madvise(map, length, MADV_SEQUENTIAL);
+		data = (const char*)map;
+	}
+	::close(fd);
+	return true;
+#endif
+}
+//------------------------------------------------------
+void mapped_file::close()
+{
+#ifdef _WIN32
+	contents_copy.clear();
+#else
+	if (data != nullptr)
+		munmap((void*)data, length);
+#endif
+	data = nullptr;
+	length = 0;
+}
+//------------------------------------------------------
+// the same characters operator>> skips
+static bool is_space(char c)
+{
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+//------------------------------------------------------
+static int lowest_bit(uint64_t x)
+{
+#ifdef _MSC_VER
+	unsigned long i;
+	_BitScanForward64(&i, x);
+	return (int)i;
+#else
+	return __builtin_ctzll(x);
+#endif
+}
+//------------------------------------------------------
+// one bit per character of a block of up to 64, set for whitespace
+static uint64_t space_mask(const char* p, size_t n)
+{
+	uint64_t mask = 0;
+	size_t i = 0;
+#ifdef DICT_SSE2
+	// 16 characters per step: ' ' or '\t'..'\r'; bytes of multibyte UTF-8 are negative and never match
+	const __m128i space = _mm_set1_epi8(' '), below_tab = _mm_set1_epi8('\t' - 1), above_cr = _mm_set1_epi8('\r' + 1);
+	for (; i + 16 <= n; i += 16)
+	{
+		__m128i c = _mm_loadu_si128((const __m128i*)(p + i));
+		__m128i hit = _mm_or_si128(_mm_cmpeq_epi8(c, space),
+			_mm_and_si128(_mm_cmpgt_epi8(c, below_tab), _mm_cmplt_epi8(c, above_cr)));
+		mask |= (uint64_t)(uint32_t)_mm_movemask_epi8(hit) << i;
+	}
+#endif
+	for (; i < n; i++)
+		mask |= (uint64_t)is_space(p[i]) << i;
+	return mask;
+}
+//------------------------------------------------------
+// calls f for every whitespace separated word of text. Words are found 64 characters at a time
+// from the edges of the whitespace mask, which avoids a mispredicted branch on every word end
+template<class F>
+static void for_each_token(string_view text, F f)
+{
+	const char* base = text.data();
+	uint64_t previous = 1;	//whether the character before the block was whitespace
+	size_t word_start = 0;
+	bool in_word = false;
+
+	for (size_t at = 0; at < text.size(); at += 64)
+	{
+		size_t n = min<size_t>(64, text.size() - at);
+		uint64_t spaces = space_mask(base + at, n);
+		uint64_t valid = n == 64 ? ~0ull : (1ull << n) - 1;
+		uint64_t shifted = spaces << 1 | previous;
+
+		uint64_t edges = (spaces ^ shifted) & valid;	//word starts and word ends, alternating
+		previous = spaces >> (n - 1) & 1;
+
+		for (; edges != 0; edges &= edges - 1)
+		{
+			size_t pos = at + lowest_bit(edges);
+			if (!in_word)
+				word_start = pos;
+			else
+				f(string_view(base + word_start, pos - word_start));
+			in_word = !in_word;
+		}
+	}
+
+	if (in_word)
+		f(string_view(base + word_start, text.size() - word_start));
+}
+//------------------------------------------------------
+// number of words in text, from the same masks as for_each_token
+static size_t count_tokens(string_view text)
+{
+	uint64_t previous = 1;
+	size_t count = 0;
+
+	for (size_t at = 0; at < text.size(); at += 64)
+	{
+		size_t n = min<size_t>(64, text.size() - at);
+		uint64_t spaces = space_mask(text.data() + at, n);
+		uint64_t valid = n == 64 ? ~0ull : (1ull << n) - 1;
+
+		count += bitset<64>(~spaces & (spaces << 1 | previous) & valid).count();
+		previous = spaces >> (n - 1) & 1;
+	}
+
+	return count;
+}
+//------------------------------------------------------
+vector<term_pair> read_pairs(string_view text)
+{
+	const size_t min_chunk = 1 << 20;
+	size_t chunks = min((size_t)max(1u, thread::hardware_concurrency()), text.size() / min_chunk + 1);
+
+	// chunk borders are moved forward onto whitespace so no word is cut in two
+	vector<string_view> parts;
+	size_t begin = 0;
+	for (size_t i = 1; i <= chunks; i++)
+	{
+		size_t at = max(begin, text.size() * i / chunks);
+		while (at < text.size() && !is_space(text[at]))
+			at++;
+		parts.push_back(text.substr(begin, at - begin));
+		begin = at;
+	}
+
+	// words alternate eng, pol across the whole file, so every chunk first counts its words
+	// to know where its own ones land, then writes them straight into place
+	vector<size_t> first_word(chunks + 1, 0);
+	for_each_chunk(chunks, [&](size_t i) {
+		first_word[i + 1] = count_tokens(parts[i]);
+		});
+	for (size_t i = 0; i < chunks; i++)
+		first_word[i + 1] += first_word[i];
+
+	vector<term_pair> pairs(first_word[chunks] / 2);
+	for_each_chunk(chunks, [&](size_t i) {
+		size_t n = first_word[i];
+		for_each_token(parts[i], [&](string_view token) {
+			if (n / 2 < pairs.size())
+				(n % 2 == 0 ? pairs[n / 2].first : pairs[n / 2].second) = token;
+			n++;
+			});
+		});
+
+	return pairs;
+}
+//------------------------------------------------------
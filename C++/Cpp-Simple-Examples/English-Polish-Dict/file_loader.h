@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "criteria.h"
+
+using std::string;
+using std::string_view;
+using std::thread;
+using std::vector;
+
+
+//read-only view of a whole file, mapped into memory where the platform allows it
+class mapped_file
+{
+	const char* data = nullptr;
+	size_t length = 0;
+#ifdef _WIN32
+	string contents_copy;	//plain read instead of a mapping
+#endif
+
+public:
+	mapped_file() = default;
+	~mapped_file();
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	bool open(const string& file_name);
+	void close();
+
+	string_view contents() const { return string_view(data, length); }
+};
+
+
+//runs body(i) for every chunk on its own thread, chunk 0 on the calling one
+template<class F>
+void for_each_chunk(size_t chunks, F body)
+{
+	vector<thread> workers;
+	for (size_t i = 1; i < chunks; i++)
+		workers.emplace_back(body, i);
+	body(0);
+	for (thread& t : workers)
+		t.join();
+}
+
+
+//splits text into (eng, pol) pairs of whitespace separated words without copying them,
+//large texts are tokenized in chunks on several threads; a trailing unpaired word is ignored
+vector<term_pair> read_pairs(string_view text);
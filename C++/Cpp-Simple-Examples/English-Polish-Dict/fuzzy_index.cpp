@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <random>
+using namespace std;
+#include "fuzzy_index.h"
+#include "utf8.h"
+
+
+//------------------------------------------------------
+static vector<char32_t> code_points(string_view s)
+{
+	vector<char32_t> out;
+	for (size_t pos = 0; pos < s.size(); )
+	{
+		size_t n = utf8_length(s, pos);
+		out.push_back(utf8_decode(s, pos, n));
+		pos += n;
+	}
+	return out;
+}
+//------------------------------------------------------
+levenshtein_pattern::levenshtein_pattern(string_view s) : chars(code_points(s))
+{
+	if (chars.size() > 64)
+		return;
+
+	for (size_t i = 0; i < chars.size(); i++)
+	{
+		char32_t c = chars[i];
+		if (c < 128)
+		{
+			ascii[c] |= 1ull << i;
+			continue;
+		}
+
+		auto it = find_if(other.begin(), other.end(), [c](const pair<char32_t, uint64_t>& p) { return p.first == c; });
+		if (it == other.end())
+			other.emplace_back(c, 1ull << i);
+		else
+			it->second |= 1ull << i;
+	}
+}
+//------------------------------------------------------
+uint64_t levenshtein_pattern::positions(char32_t c) const
+{
+	if (c < 128)
+		return ascii[c];
+	for (const auto& p : other)
+		if (p.first == c)
+			return p.second;
+	return 0;
+}
+//------------------------------------------------------
+unsigned levenshtein_pattern::distance(string_view text) const
+{
+	size_t m = chars.size();
+
+	if (m > 64)
+	{
+		vector<char32_t> t = code_points(text);
+		vector<unsigned> row(m + 1);
+		for (size_t i = 0; i <= m; i++)
+			row[i] = (unsigned)i;
+
+		for (size_t j = 1; j <= t.size(); j++)
+		{
+			unsigned diagonal = row[0];
+			row[0] = (unsigned)j;
+			for (size_t i = 1; i <= m; i++)
+			{
+				unsigned up = row[i];
+				row[i] = min({ row[i] + 1, row[i - 1] + 1, diagonal + (chars[i - 1] != t[j - 1]) });
+				diagonal = up;
+			}
+		}
+		return row[m];
+	}
+
+	// Myers / Hyyro: vertical deltas of the current column as +1 (pv) and -1 (mv) bit vectors
+	unsigned score = (unsigned)m;
+	if (m == 0)
+	{
+		for (size_t pos = 0; pos < text.size(); pos += utf8_length(text, pos))
+			score++;
+		return score;
+	}
+
+	uint64_t pv = ~0ull, mv = 0;
+	const uint64_t last = 1ull << (m - 1);
+
+	for (size_t pos = 0; pos < text.size(); )
+	{
+		size_t n = utf8_length(text, pos);
+		uint64_t eq = positions(utf8_decode(text, pos, n));
+		pos += n;
+
+		uint64_t xv = eq | mv;
+		uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+		uint64_t ph = mv | ~(xh | pv);
+		uint64_t mh = pv & xh;
+
+		if (ph & last)
+			score++;
+		else if (mh & last)
+			score--;
+
+		// the top row grows by one per character, hence the 1 shifted in
+		ph = ph << 1 | 1;
+		mh <<= 1;
+		pv = mh | ~(xv | ph);
+		mv = ph & xv;
+	}
+
+	return score;
+}
+//------------------------------------------------------
+void fuzzy_index::build(vector<string_view> terms)
+{
+	nodes.clear();
+	nodes.reserve(terms.size());
+
+	// sorted input would make a very lopsided tree
+	shuffle(terms.begin(), terms.end(), mt19937(terms.size()));
+
+	for (string_view term : terms)
+	{
+		if (nodes.empty())
+		{
+			nodes.push_back({ term, {} });
+			continue;
+		}
+
+		levenshtein_pattern pattern(term);
+		uint32_t at = 0;
+		while (true)
+		{
+			unsigned d = pattern.distance(nodes[at].term);
+			if (d == 0)
+				break;
+
+			auto& children = nodes[at].children;
+			auto it = find_if(children.begin(), children.end(), [d](const pair<unsigned, uint32_t>& c) { return c.first == d; });
+			if (it != children.end())
+			{
+				at = it->second;
+				continue;
+			}
+
+			children.emplace_back(d, (uint32_t)nodes.size());
+			nodes.push_back({ term, {} });
+			break;
+		}
+	}
+}
+//------------------------------------------------------
+vector<pair<string_view, unsigned>> fuzzy_index::find(string_view query, unsigned k) const
+{
+	vector<pair<string_view, unsigned>> found;
+	if (nodes.empty())
+		return found;
+
+	levenshtein_pattern pattern(query);
+	vector<uint32_t> pending{ 0 };
+
+	while (!pending.empty())
+	{
+		const node& at = nodes[pending.back()];
+		pending.pop_back();
+
+		unsigned d = pattern.distance(at.term);
+		if (d <= k)
+			found.emplace_back(at.term, d);
+
+		// triangle inequality: anything within k of the query is within d +- k of this node
+		for (const auto& child : at.children)
+			if (child.first + k >= d && child.first <= d + k)
+				pending.push_back(child.second);
+	}
+
+	sort(found.begin(), found.end(), [](const pair<string_view, unsigned>& a, const pair<string_view, unsigned>& b) {
+		return a.second != b.second ? a.second < b.second : a.first < b.first;
+		});
+	return found;
+}
+//------------------------------------------------------
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using std::pair;
+using std::string_view;
+using std::vector;
+
+
+//edit distance from one fixed word to many others, counted in code points.
+//Words up to 64 characters use Myers' bit-parallel algorithm (one pass of word operations per character),
+//longer ones the plain dynamic programming table
+class levenshtein_pattern
+{
+	vector<char32_t> chars;
+	uint64_t ascii[128] = {};				//positions of each ASCII character in the word, one bit each
+	vector<pair<char32_t, uint64_t>> other;	//the same for everything else
+
+	uint64_t positions(char32_t c) const;
+
+public:
+	explicit levenshtein_pattern(string_view s);
+
+	unsigned distance(string_view text) const;
+};
+
+
+//BK-tree: every child hangs under the distance to its parent, so a query within k
+//only has to visit children whose distance lies in [d - k, d + k]
+class fuzzy_index
+{
+	struct node
+	{
+		string_view term;
+		vector<pair<unsigned, uint32_t>> children;	//(distance, node)
+	};
+
+	vector<node> nodes;
+
+public:
+	//the views have to outlive the index
+	void build(vector<string_view> terms);
+
+	//terms within distance k of query, closest first
+	vector<pair<string_view, unsigned>> find(string_view query, unsigned k) const;
+};
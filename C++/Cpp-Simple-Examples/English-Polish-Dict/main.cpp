@@ -1,21 +1,30 @@
+#include <filesystem>
 #include <iostream>
+#include <system_error>
 using namespace std;
-#include <ctime>
 #include "word.h"
 #include "dict.h"
 //------------------------------------------------------
 
 int main()
 {
-	srand((unsigned)time(0));
-
 	dictionary	S{ {"matrix","macierz"},{"number","liczba"},{"field","cialo"} };//these selected words should always be in the dictionary
 	
 	cout << "Dictionary Starter:" << endl;
 	cout << S << endl;
 		
 	//-------------------------------------------------------------
-	if (!S.words_from_file("daily_words.txt")) 
+	// a saved snapshot is mapped as it is, the word list is parsed when there is none or it was edited since
+	error_code no_snapshot, no_list;
+	auto snapshot_time = filesystem::last_write_time("dictionary.bin", no_snapshot);
+	auto list_time = filesystem::last_write_time("daily_words.txt", no_list);
+	bool snapshot_current = !no_snapshot && (no_list || snapshot_time >= list_time);
+
+	if (snapshot_current && S.load_words("dictionary.bin"))
+	{
+		cout << "Snapshot dictionary.bin loaded" << endl;
+	}
+	else if (!S.words_from_file("daily_words.txt")) 
 	{
 		cout<<"File not found"<<endl;
 		return 0;
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+using namespace std;
+#include "perfect_hash.h"
+
+
+//------------------------------------------------------
+// splitmix64 finalizer
+static uint64_t mix(uint64_t x)
+{
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ull;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebull;
+	return x ^ (x >> 31);
+}
+//------------------------------------------------------
+uint64_t hash_text(string_view s, uint64_t seed)
+{
+	uint64_t h = mix(seed ^ (s.size() * 0x9e3779b97f4a7c15ull));
+
+	size_t i = 0;
+	for (; i + 8 <= s.size(); i += 8)
+	{
+		uint64_t w;
+		memcpy(&w, s.data() + i, 8);
+		h = mix(h ^ w);
+	}
+	if (i < s.size())
+	{
+		uint64_t w = 0;
+		memcpy(&w, s.data() + i, s.size() - i);
+		h = mix(h ^ w);
+	}
+	return h;
+}
+//------------------------------------------------------
+static uint64_t position(uint64_t hash, int level, size_t bit_count)
+{
+	return mix(hash + (uint64_t)level * 0x9e3779b97f4a7c15ull) % bit_count;
+}
+//------------------------------------------------------
+static size_t popcount(uint64_t w)
+{
+	return bitset<64>(w).count();
+}
+//------------------------------------------------------
+void perfect_hash::build(vector<uint64_t> hashes, double gamma)
+{
+	levels.clear();
+	leftovers.clear();
+	placed = 0;
+
+	for (int l = 0; l < max_levels && !hashes.empty(); l++)
+	{
+		size_t words = max<size_t>(1, (size_t)(hashes.size() * gamma + 63) / 64);
+		size_t bit_count = words * 64;
+
+		vector<uint64_t> seen(words), twice(words);
+		for (uint64_t h : hashes)
+		{
+			uint64_t p = position(h, l, bit_count);
+			uint64_t bit = 1ull << (p % 64);
+			if (seen[p / 64] & bit)
+				twice[p / 64] |= bit;
+			seen[p / 64] |= bit;
+		}
+
+		// keys alone on their bit stay on this level, the rest try the next one
+		level lv;
+		lv.bits.resize(words);
+		size_t kept = 0;
+		for (uint64_t h : hashes)
+		{
+			uint64_t p = position(h, l, bit_count);
+			uint64_t bit = 1ull << (p % 64);
+			if (twice[p / 64] & bit)
+				hashes[kept++] = h;
+			else
+				lv.bits[p / 64] |= bit;
+		}
+		hashes.resize(kept);
+
+		lv.ranks.resize((words + 7) / 8);
+		for (size_t w = 0; w < words; w++)
+		{
+			if (w % 8 == 0)
+				lv.ranks[w / 8] = (uint32_t)placed;
+			placed += popcount(lv.bits[w]);
+		}
+		levels.push_back(move(lv));
+	}
+
+	leftovers = move(hashes);
+	sort(leftovers.begin(), leftovers.end());
+}
+//------------------------------------------------------
+uint64_t perfect_hash::lookup(uint64_t hash) const
+{
+	for (size_t l = 0; l < levels.size(); l++)
+	{
+		const level& lv = levels[l];
+		uint64_t p = position(hash, (int)l, lv.bits.size() * 64);
+		uint64_t w = p / 64;
+		uint64_t bit = 1ull << (p % 64);
+
+		if (lv.bits[w] & bit)
+		{
+			uint64_t rank = lv.ranks[w / 8];
+			for (uint64_t i = w / 8 * 8; i < w; i++)
+				rank += popcount(lv.bits[i]);
+			return rank + popcount(lv.bits[w] & (bit - 1));
+		}
+	}
+
+	auto it = lower_bound(leftovers.begin(), leftovers.end(), hash);
+	if (it != leftovers.end() && *it == hash)
+		return placed + (it - leftovers.begin());
+	return size();
+}
+//------------------------------------------------------
+void perfect_hash::save(string& out) const
+{
+	vector<uint64_t> counts = { levels.size(), placed };
+	put_array(out, counts);
+	for (const level& lv : levels)
+	{
+		put_array(out, lv.bits);
+		put_array(out, lv.ranks);
+	}
+	put_array(out, leftovers);
+}
+//------------------------------------------------------
+// the ranks are counted again, so a lookup can trust them to stay below size()
+bool perfect_hash::load(string_view& in)
+{
+	levels.clear();
+	leftovers.clear();
+	placed = 0;
+
+	vector<uint64_t> counts;
+	bool good = take_array(in, counts) && counts.size() == 2 && counts[0] <= max_levels;
+	for (uint64_t l = 0; good && l < counts[0]; l++)
+	{
+		level lv;
+		good = take_array(in, lv.bits) && take_array(in, lv.ranks)
+			&& !lv.bits.empty() && lv.ranks.size() == (lv.bits.size() + 7) / 8;
+		for (size_t w = 0; good && w < lv.bits.size(); w++)
+		{
+			if (w % 8 == 0)
+				good = lv.ranks[w / 8] == placed;
+			placed += popcount(lv.bits[w]);
+		}
+		levels.push_back(move(lv));
+	}
+	good = good && placed == counts[1] && take_array(in, leftovers) && is_sorted(leftovers.begin(), leftovers.end());
+
+	if (!good)
+	{
+		levels.clear();
+		leftovers.clear();
+		placed = 0;
+	}
+	return good;
+}
+//------------------------------------------------------
@@ -0,0 +1,78 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+
+//64-bit hash of a term, 8 bytes per step
+uint64_t hash_text(string_view s, uint64_t seed = 0);
+
+
+//appends the length of an array of plain values and its bytes, padded to 8
+template<class T>
+void put_array(string& out, const vector<T>& values)
+{
+	uint64_t count = values.size();
+	out.append((const char*)&count, sizeof(count));
+	out.append((const char*)values.data(), count * sizeof(T));
+	out.append((8 - count * sizeof(T) % 8) % 8, '\0');
+}
+
+//reads an array written by put_array off the front of in, false if in is cut short
+template<class T>
+bool take_array(string_view& in, vector<T>& values)
+{
+	uint64_t count;
+	if (in.size() < sizeof(count))
+		return false;
+	memcpy(&count, in.data(), sizeof(count));
+	in.remove_prefix(sizeof(count));
+
+	if (count > in.size() / sizeof(T))
+		return false;
+	size_t bytes = count * sizeof(T);
+	values.resize(count);
+	memcpy(values.data(), in.data(), bytes);
+	in.remove_prefix(std::min(in.size(), (bytes + 7) / 8 * 8));
+	return true;
+}
+
+
+//minimal perfect hash in the style of BBHash: maps n distinct 64-bit key hashes onto 0..n-1 without collisions.
+//Each level is a bit array of about gamma bits per remaining key; a key settles in the first level where no other
+//key hashed to the same bit, and its slot is the number of settled bits before it. About 3.7 bits per key at gamma 2
+class perfect_hash
+{
+	struct level
+	{
+		vector<uint64_t> bits;
+		vector<uint32_t> ranks;	//set bits before every block of 8 words, counted over all levels
+	};
+
+	static const int max_levels = 24;
+
+	vector<level> levels;
+	vector<uint64_t> leftovers;	//keys no level could place (almost never), sorted; slots follow the levels
+	uint64_t placed = 0;
+
+public:
+	//the hashes have to be distinct
+	void build(vector<uint64_t> hashes, double gamma = 2.0);
+
+	//slot of a key from the build; any other key gets some slot in range (or size() when there is none)
+	uint64_t lookup(uint64_t hash) const;
+
+	uint64_t size() const { return placed + leftovers.size(); }
+
+	//appends the levels to out, so a snapshot can keep the hash instead of building it again
+	void save(string& out) const;
+	//takes a hash written by save off the front of in, false (and empty) if it is cut short or inconsistent
+	bool load(string_view& in);
+};
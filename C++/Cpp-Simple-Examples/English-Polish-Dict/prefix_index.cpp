@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <string>
+using namespace std;
+#include "prefix_index.h"
+#include "collation.h"
+#include "utf8.h"
+
+
+//------------------------------------------------------
+void prefix_index::build(const vector<pair<string_view, string_view>>& sorted_terms)
+{
+	terms.clear();
+	keys.clear();
+	for (const auto& [term, key] : sorted_terms)
+	{
+		terms.push_back(term);
+		keys.push_back(key);
+	}
+	nodes.clear();
+	root = none;
+
+	// a key has up to 65535 bytes and the tree a level for each, so the links still to be made are kept on a stack
+	// instead of in recursive calls; they come off it in the order the calls would make them
+	vector<group> groups;
+	vector<pending_link> pending = { { false, 0, terms.size(), 0, none, nullptr } };
+	while (!pending.empty())
+	{
+		pending_link p = pending.back();
+		pending.pop_back();
+
+		if (!p.groups)
+		{
+			// a key equal to the shared prefix sorts first and belongs to the parent node only
+			size_t begin = p.begin;
+			while (begin < p.end && keys[begin].size() == p.offset)
+				begin++;
+
+			size_t first_group = groups.size();
+			for (size_t i = begin; i < p.end; )
+			{
+				auto symbol = (unsigned char)keys[i][p.offset];
+
+				size_t j = i + 1;
+				while (j < p.end && (unsigned char)keys[j][p.offset] == symbol)
+					j++;
+
+				groups.push_back({ i, j, symbol });
+				i = j;
+			}
+			pending.push_back({ true, first_group, groups.size(), p.offset, p.parent, p.link });
+			continue;
+		}
+		if (p.begin == p.end)
+			continue;
+
+		// balanced lo/hi links over the bytes found at one position
+		size_t mid = p.begin + (p.end - p.begin) / 2;
+		const group& g = groups[mid];
+
+		uint32_t at = (uint32_t)nodes.size();
+		nodes.push_back({ g.symbol, none, none, none, (uint32_t)g.begin, (uint32_t)(g.end - g.begin) });
+		(p.parent == none ? root : nodes[p.parent].*p.link) = at;
+
+		// the lo side first, then the hi side, then the next position
+		pending.push_back({ false, g.begin, g.end, p.offset + 1, at, &node::eq });
+		pending.push_back({ true, mid + 1, p.end, p.offset, at, &node::hi });
+		pending.push_back({ true, p.begin, mid, p.offset, at, &node::lo });
+	}
+}
+//------------------------------------------------------
+bool prefix_index::find_range(string_view key, size_t& first, size_t& count) const
+{
+	first = 0;
+	count = terms.size();
+	uint32_t at = root;
+
+	for (size_t pos = 0; pos < key.size(); pos++)
+	{
+		uint32_t symbol = (unsigned char)key[pos];
+		while (at != none && nodes[at].symbol != symbol)
+			at = symbol < nodes[at].symbol ? nodes[at].lo : nodes[at].hi;
+		if (at == none)
+			return false;
+
+		first = nodes[at].first;
+		count = nodes[at].count;
+		at = nodes[at].eq;
+	}
+	return count > 0;
+}
+//------------------------------------------------------
+vector<string_view> prefix_index::complete(string_view prefix, size_t k) const
+{
+	size_t whole = 0;
+	while (whole < prefix.size() && !utf8_truncated(prefix, whole))
+		whole += utf8_length(prefix, whole);
+	string key = collation_key(prefix.substr(0, whole));
+
+	// ranges of matching terms, in key order and not overlapping. The keys going on with 0xff only lengthen
+	// the last letter of the prefix into an accented one, they sort last and are left out
+	vector<pair<size_t, size_t>> ranges;
+	auto add = [&](const string& start) {
+		size_t first, count, longer_first, longer_count;
+		if (!find_range(start, first, count))
+			return;
+		if (find_range(start + '\xff', longer_first, longer_count))
+			count -= longer_count;
+		if (count > 0)
+			ranges.emplace_back(first, count);
+	};
+	if (whole == prefix.size())
+		add(key);
+	else
+	{
+		// a character still being typed may become any letter starting with its bytes,
+		// or another character, whose key repeats the bytes after 0xfe
+		string_view partial = prefix.substr(whole);
+		for (const string& letter : collation_letters_starting_with(partial))
+			add(key + letter);
+		append_collation_key(key, partial);
+		add(key);
+	}
+
+	vector<string_view> out;
+	for (const auto& [begin, n] : ranges)
+		for (size_t i = begin; i < begin + n && out.size() < k; i++)
+			out.push_back(terms[i]);
+	return out;
+}
+//------------------------------------------------------
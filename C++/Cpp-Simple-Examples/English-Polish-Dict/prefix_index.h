@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using std::pair;
+using std::string_view;
+using std::vector;
+
+
+//ternary search tree over the collation keys of the terms (see collation.h), one node per key byte,
+//for completing a typed prefix whatever its case. The terms are kept in key order, so every node only
+//records the range of terms below it and the first k completions are simply the next k terms of that range.
+class prefix_index
+{
+	static const uint32_t none = UINT32_MAX;
+
+	struct node
+	{
+		uint32_t symbol;		//one key byte
+		uint32_t lo, eq, hi;	//smaller byte, next byte, larger byte
+		uint32_t first, count;	//terms whose key starts with the bytes ending at this node
+	};
+
+	vector<string_view> terms;	//in key order, no repeated spellings
+	vector<string_view> keys;	//the key of every term
+	vector<node> nodes;
+	uint32_t root = none;
+
+	//terms [begin, end) whose keys share one byte at a position
+	struct group
+	{
+		size_t begin, end;
+		uint32_t symbol;
+	};
+
+	//a link still to be made while building: to the subtree of the terms [begin, end) whose keys share their
+	//first offset bytes, or with groups, to the balanced tree over the groups [begin, end) of one such position
+	struct pending_link
+	{
+		bool groups;
+		size_t begin, end, offset;
+		uint32_t parent;		//none for the root
+		uint32_t node::* link;
+	};
+
+	//terms whose key starts with key, as first and count; false if there are none
+	bool find_range(string_view key, size_t& first, size_t& count) const;
+
+public:
+	//(term, collation key) pairs sorted by key, the views have to outlive the index
+	void build(const vector<pair<string_view, string_view>>& sorted_terms);
+
+	//up to k terms whose key starts with the key of prefix, in collation order
+	vector<string_view> complete(string_view prefix, size_t k) const;
+};
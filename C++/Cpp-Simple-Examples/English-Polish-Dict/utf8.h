@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+using std::string_view;
+
+
+//bytes a character announces by its first byte
+inline size_t utf8_expected(unsigned char lead)
+{
+	return lead < 0xc0 || lead >= 0xf8 ? 1 : lead >= 0xf0 ? 4 : lead >= 0xe0 ? 3 : 2;
+}
+
+//bytes taken by the character starting at pos. The continuation bytes are not checked, so all characters
+//with the same first byte have the same length (only the end of the string can cut one short)
+inline size_t utf8_length(string_view s, size_t pos)
+{
+	size_t n = utf8_expected((unsigned char)s[pos]);
+	return pos + n > s.size() ? s.size() - pos : n;
+}
+
+//whether the string ends inside the multibyte character starting at pos
+inline bool utf8_truncated(string_view s, size_t pos)
+{
+	return pos + utf8_expected((unsigned char)s[pos]) > s.size();
+}
+
+//code point of the character starting at pos (a cut off character gives its lead byte)
+inline char32_t utf8_decode(string_view s, size_t pos, size_t n)
+{
+	unsigned char lead = (unsigned char)s[pos];
+	if (n != utf8_expected(lead) || n == 1)
+		return lead;
+
+	char32_t cp = lead & (0x7f >> n);
+	for (size_t i = 1; i < n; i++)
+		cp = cp << 6 | ((unsigned char)s[pos + i] & 0x3f);
+	return cp;
+}
+
+//the character's bytes packed left-aligned into 32 bits, so comparing symbols agrees with comparing bytes
+inline uint32_t utf8_symbol(string_view s, size_t pos, size_t n)
+{
+	uint32_t sym = 0;
+	for (size_t i = 0; i < 4; i++)
+		sym = sym << 8 | (i < n ? (unsigned char)s[pos + i] : 0);
+	return sym;
+}
@@ -23,6 +23,5 @@ public:
 	friend istream& operator>>(istream& in, word& s);
 
 	friend class dictionary;
-	friend class Cmp;	//functor
 	
 };
\ No newline at end of file
@@ -0,0 +1,540 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+using namespace std;
+#include "word_store.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+//------------------------------------------------------
+uint64_t generation_tag::next()
+{
+	static atomic<uint64_t> counter{ 1 };
+	return counter.fetch_add(1, memory_order_relaxed);
+}
+//------------------------------------------------------
+// appends a term and its key to the pool, offsets are kept in 32 bits and lengths in 16
+uint32_t word_store::intern(string& to, string_view term, string_view key)
+{
+	if (term.size() > UINT16_MAX || key.size() > UINT16_MAX)
+		throw length_error("Dictionary term is too long");
+	if (to.size() + term.size() + key.size() > UINT32_MAX)
+		throw length_error("Dictionary pool is full");
+
+	uint32_t offset = (uint32_t)to.size();
+	to.append(term);
+	to.append(key);
+	return offset;
+}
+//------------------------------------------------------
+// end of the pool bytes an entry uses
+static size_t entry_end(const entry& e)
+{
+	return max((size_t)e.eng + e.eng_len + e.eng_key_len, (size_t)e.pol + e.pol_len + e.pol_key_len);
+}
+//------------------------------------------------------
+// a hint to start loading the cache line of p
+static void prefetch(const void* p)
+{
+#ifdef _MSC_VER
+	_mm_prefetch((const char*)p, _MM_HINT_T0);
+#else
+	__builtin_prefetch(p);
+#endif
+}
+//------------------------------------------------------
+// first 8 bytes as a big-endian number, so comparing these agrees with comparing the strings up to a tie
+static uint64_t prefix_key(string_view s)
+{
+	uint64_t key = 0;
+	if (s.size() >= 8)
+	{
+		unsigned char b[8];
+		memcpy(b, s.data(), 8);
+		for (unsigned char c : b)
+			key = key << 8 | c;
+		return key;
+	}
+	for (size_t i = 0; i < 8; i++)
+		key = key << 8 | (i < s.size() ? (unsigned char)s[i] : 0);
+	return key;
+}
+//------------------------------------------------------
+struct keyed
+{
+	uint64_t key;
+	uint32_t pos;
+};
+//------------------------------------------------------
+// stable LSD radix sort on the keys, one byte per pass; passes where every key has the same byte are skipped.
+// The counts of all eight bytes are taken in a single read of the items
+static void radix_sort(vector<keyed>& items)
+{
+	vector<keyed> buffer(items.size());
+	vector<size_t> counts(8 * 256);
+	for (const keyed& k : items)
+		for (int b = 0; b < 8; b++)
+			counts[b * 256 + (k.key >> 8 * b & 0xff)]++;
+
+	for (int b = 0; b < 8; b++)
+	{
+		size_t* count = &counts[b * 256];
+		int shift = 8 * b;
+		if (count[items.empty() ? 0 : items[0].key >> shift & 0xff] == items.size())
+			continue;
+
+		size_t start = 0;
+		for (int v = 0; v < 256; v++)
+		{
+			size_t n = count[v];
+			count[v] = start;
+			start += n;
+		}
+		for (const keyed& k : items)
+			buffer[count[k.key >> shift & 0xff]++] = k;
+		items.swap(buffer);
+	}
+}
+//------------------------------------------------------
+// positions in the given order of their collation keys: the items carry an 8-byte prefix of each leading key
+// and are radix sorted by it, only runs with equal prefixes are compared in full; equal keys keep their positions in order.
+// With unique_keys only the first position of equal keys is returned
+template<class Keys>
+static vector<uint32_t> sorted_order(vector<keyed> items, Keys keys_of, Cmp::sort how, bool unique_keys = false)
+{
+	radix_sort(items);
+	size_t n = items.size();
+	Cmp cmp(how);
+	vector<uint32_t> order;
+	order.reserve(n);
+	for (size_t i = 0, j; i < n; i = j)
+	{
+		for (j = i + 1; j < n && items[j].key == items[i].key; j++);
+		if (j - i == 1)
+		{
+			order.push_back(items[i].pos);
+			continue;
+		}
+
+		std::sort(items.begin() + i, items.begin() + j, [&](const keyed& a, const keyed& b) {
+			term_pair ka = keys_of(a.pos), kb = keys_of(b.pos);
+			return cmp(ka, kb) || (ka == kb && a.pos < b.pos);
+			});
+		// equal keys can only be in the same run
+		for (size_t r = i; r < j; r++)
+			if (!unique_keys || r == i || keys_of(items[r].pos) != keys_of(items[r - 1].pos))
+				order.push_back(items[r].pos);
+	}
+	return order;
+}
+//------------------------------------------------------
+// where the keys of a pair start in the key buffer, the Polish one right after the English one;
+// a length of 0 stands for a term that is its own key, which is not written there
+struct pair_keys
+{
+	uint32_t at;
+	uint16_t eng_len, pol_len;
+};
+//------------------------------------------------------
+void word_store::build(vector<term_pair> pairs)
+{
+	if (pairs.size() + size() > UINT32_MAX)
+		throw length_error("Too many dictionary entries");
+
+	// the stored entries go first, so they win over new pairs that only differ in case
+	size_t stored = size();
+	pairs.insert(pairs.begin(), stored, term_pair());
+
+	// the keys that differ from their terms end up in one buffer; keys of the new pairs are written by chunks
+	// on several threads, each into a buffer of its own large enough for the longest possible keys, and copied
+	// in after the stored ones. The English prefixes for the sort are read while the keys just written are still in cache
+	vector<pair_keys> collated(pairs.size());
+	vector<keyed> items(pairs.size());
+	auto collate = [&](size_t i, const char* base, char* out, char* eng_end, char* pol_end) {
+		if (pairs[i].first.size() > UINT16_MAX || pairs[i].second.size() > UINT16_MAX || eng_end - out > UINT16_MAX || pol_end - eng_end > UINT16_MAX)
+			return "Dictionary term is too long";
+		if (out - base > UINT32_MAX)
+			return "Dictionary pool is full";
+		collated[i] = { (uint32_t)(out - base), (uint16_t)(eng_end - out), (uint16_t)(pol_end - eng_end) };
+		items[i] = { prefix_key(eng_end > out ? string_view(out, eng_end - out) : pairs[i].first), (uint32_t)i };
+		return (const char*)nullptr;
+	};
+
+	const size_t min_chunk = 1 << 12;
+	size_t added = pairs.size() - stored;
+	size_t chunks = min((size_t)max(1u, thread::hardware_concurrency()), added / min_chunk + 1);
+	vector<unique_ptr<char[]>> chunk_keys(chunks);
+	vector<size_t> chunk_bytes(chunks);
+	vector<const char*> failed(chunks);		//the error a chunk stopped at, thrown once every thread is done
+	for_each_chunk(chunks, [&](size_t c) {
+		size_t first = stored + added * c / chunks, last = stored + added * (c + 1) / chunks;
+		size_t bytes = 0;
+		for (size_t i = first; i < last; i++)
+			bytes += 2 * (pairs[i].first.size() + pairs[i].second.size());
+		chunk_keys[c].reset(new char[bytes + 1]);
+
+		char* base = chunk_keys[c].get();
+		char* out = base;
+		for (size_t i = first; i < last && !failed[c]; i++)
+		{
+			char* eng_end = collates_as_itself(pairs[i].first) ? out : write_collation_key(pairs[i].first, out);
+			char* pol_end = collates_as_itself(pairs[i].second) ? eng_end : write_collation_key(pairs[i].second, eng_end);
+			failed[c] = collate(i, base, out, eng_end, pol_end);
+			out = pol_end;
+		}
+		chunk_bytes[c] = out - base;
+		});
+	for (const char* error : failed)
+		if (error)
+			throw length_error(error);
+
+	size_t key_bytes = 0;
+	for (size_t i = 0; i < stored; i++)
+		key_bytes += all_entries()[i].eng_key_len + all_entries()[i].pol_key_len;
+	for (size_t bytes : chunk_bytes)
+		key_bytes += bytes;
+	if (key_bytes > UINT32_MAX)
+		throw length_error("Dictionary pool is full");
+	unique_ptr<char[]> key_chars(new char[key_bytes + 1]);
+
+	char* out = key_chars.get();
+	for (size_t i = 0; i < stored; i++)
+	{
+		const entry& e = all_entries()[i];
+		pairs[i] = terms(e);
+		char* eng_end = copy_n(eng_key(e).data(), e.eng_key_len, out);
+		char* pol_end = copy_n(pol_key(e).data(), e.pol_key_len, eng_end);
+		collate(i, key_chars.get(), out, eng_end, pol_end);
+		out = pol_end;
+	}
+	for (size_t c = 0; c < chunks; c++)
+	{
+		uint32_t shift = (uint32_t)(out - key_chars.get());
+		for (size_t i = stored + added * c / chunks; i < stored + added * (c + 1) / chunks; i++)
+			collated[i].at += shift;
+		out = copy_n(chunk_keys[c].get(), chunk_bytes[c], out);
+		chunk_keys[c].reset();
+	}
+
+	auto keys_of = [&](size_t i) {
+		const pair_keys& c = collated[i];
+		const char* at = key_chars.get() + c.at;
+		return term_pair(c.eng_len ? string_view(at, c.eng_len) : pairs[i].first, c.pol_len ? string_view(at + c.eng_len, c.pol_len) : pairs[i].second);
+	};
+	vector<uint32_t> order = sorted_order(move(items), keys_of, Cmp::sort::ANG_POL, true);
+
+	// enough for every pair, dropped ones included; adding up only the kept ones would visit them in random order
+	size_t chars = (size_t)(out - key_chars.get());
+	for (size_t i = 0; i < pairs.size(); i++)
+		chars += pairs[i].first.size() + pairs[i].second.size();
+
+	// the old pool (or snapshot) stays alive until the new one is complete, the existing pairs still point into it
+	// written through a pointer and cut to size at the end, four appends per entry would cost more than the zero fill
+	string fresh(chars, '\0');
+	size_t used = 0;
+	auto put = [&](string_view term, string_view key) {
+		if (used + term.size() + key.size() > UINT32_MAX)
+			throw length_error("Dictionary pool is full");
+		uint32_t offset = (uint32_t)used;
+		memcpy(&fresh[used], term.data(), term.size());
+		memcpy(&fresh[used + term.size()], key.data(), key.size());
+		used += term.size() + key.size();
+		return offset;
+	};
+	vector<entry> built(order.size());
+
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		// the pairs are visited in sorted order, so each one is a cache miss unless asked for early:
+		// first the views, a few steps later the characters they point to
+		if (i + 32 < order.size())
+		{
+			prefetch(&pairs[order[i + 32]]);
+			prefetch(&collated[order[i + 32]]);
+		}
+		if (i + 16 < order.size())
+		{
+			prefetch(pairs[order[i + 16]].first.data());
+			prefetch(pairs[order[i + 16]].second.data());
+			prefetch(key_chars.get() + collated[order[i + 16]].at);
+		}
+		const term_pair& p = pairs[order[i]];
+		const pair_keys& c = collated[order[i]];
+		const char* key = key_chars.get() + c.at;
+		entry& e = built[i];
+		// entries sharing an English term are neighbours, they share its characters too
+		if (i > 0 && p.first == pairs[order[i - 1]].first)
+			e.eng = built[i - 1].eng;
+		else
+			e.eng = put(p.first, string_view(key, c.eng_len));
+		e.eng_len = (uint16_t)p.first.size();
+		e.eng_key_len = c.eng_len;
+		e.pol = put(p.second, string_view(key + c.eng_len, c.pol_len));
+		e.pol_len = (uint16_t)p.second.size();
+		e.pol_key_len = c.pol_len;
+	}
+
+	fresh.resize(used);
+	pool.swap(fresh);
+	entries.swap(built);
+	snapshot.reset();
+
+	// what only the pairs needed goes first, the Polish order can reuse its memory
+	pairs = vector<term_pair>();
+	collated = vector<pair_keys>();
+	key_chars.reset();
+
+	vector<keyed> pol_items(entries.size());
+	for (size_t i = 0; i < entries.size(); i++)
+		pol_items[i] = { prefix_key(pol_key(entries[i])), (uint32_t)i };
+	by_pol = sorted_order(move(pol_items), [&](size_t i) { return keys(entries[i]); }, Cmp::sort::POL_ANG);
+	generation.value = generation_tag::next();
+}
+//------------------------------------------------------
+bool word_store::insert(string_view eng, string_view pol)
+{
+	// a snapshot is only copied out for a word that is really new
+	if (contains(eng, pol))
+		return false;
+	make_writable();
+
+	lookup_key eng_key(eng), pol_key(pol);
+	term_pair k(eng_key, pol_key);
+	Cmp ang(Cmp::sort::ANG_POL), pol_first(Cmp::sort::POL_ANG);
+
+	auto e = lower_bound(entries.begin(), entries.end(), k, [&](const entry& x, const term_pair& w) { return ang(keys(x), w); });
+	auto p = lower_bound(by_pol.begin(), by_pol.end(), k, [&](uint32_t i, const term_pair& w) { return pol_first(keys(entries[i]), w); });
+
+	// a term that is its own key is stored alone
+	string_view eng_stored = collates_as_itself(eng) ? string_view() : k.first;
+	string_view pol_stored = collates_as_itself(pol) ? string_view() : k.second;
+	entry added;
+	added.eng_len = (uint16_t)eng.size();
+	added.eng_key_len = (uint16_t)eng_stored.size();
+	added.pol_len = (uint16_t)pol.size();
+	added.pol_key_len = (uint16_t)pol_stored.size();
+	added.eng = intern(pool, eng, eng_stored);
+	added.pol = intern(pool, pol, pol_stored);
+
+	uint32_t pos = (uint32_t)(e - entries.begin());
+	p = by_pol.insert(p, pos);
+	entries.insert(e, added);
+
+	// everything after the new entry moved up by one
+	for (uint32_t& i : by_pol)
+		if (i >= pos && &i != &*p)
+			i++;
+
+	generation.value = generation_tag::next();
+	return true;
+}
+//------------------------------------------------------
+bool word_store::contains(string_view eng, string_view pol) const
+{
+	lookup_key eng_key(eng), pol_key(pol);
+	term_pair k(eng_key, pol_key);
+	Cmp ang(Cmp::sort::ANG_POL);
+
+	const entry* begin = all_entries();
+	const entry* end = begin + size();
+	auto it = lower_bound(begin, end, k, [&](const entry& x, const term_pair& w) { return ang(keys(x), w); });
+	return it != end && keys(*it) == k;
+}
+//------------------------------------------------------
+vector<pair<string_view, string_view>> word_store::terms_of(lang side) const
+{
+	vector<pair<string_view, string_view>> out;
+	size_t run = 0;		//first output with the current key
+	for (size_t rank = 0; rank < size(); rank++)
+	{
+		const entry& e = at(side == lang::ENG ? Cmp::sort::ANG_POL : Cmp::sort::POL_ANG, rank);
+		string_view t = side == lang::ENG ? eng(e) : pol(e);
+		string_view key = side == lang::ENG ? eng_key(e) : pol_key(e);
+
+		// spellings of one key (differing in case) are neighbours but may alternate
+		if (out.empty() || out.back().second != key)
+			run = out.size();
+		else if (any_of(out.begin() + run, out.end(), [&](const pair<string_view, string_view>& o) { return o.first == t; }))
+			continue;
+		out.emplace_back(t, key);
+	}
+	return out;
+}
+//------------------------------------------------------
+// copy-on-write: the mapped snapshot becomes ordinary vectors before anything changes
+void word_store::make_writable()
+{
+	if (!snapshot)
+		return;
+
+	const char* mapped = mapped_pool;
+	size_t pool_bytes = 0;
+	for (size_t i = 0; i < mapped_count; i++)
+		pool_bytes = max(pool_bytes, entry_end(mapped_entries[i]));
+
+	pool.assign(mapped, pool_bytes);
+	entries.assign(mapped_entries, mapped_entries + mapped_count);
+	by_pol.assign(mapped_by_pol, mapped_by_pol + mapped_count);
+	snapshot.reset();
+}
+//------------------------------------------------------
+// Snapshot layout, native byte order, every section starting on 8 bytes:
+//   snapshot_header
+//   pool         pool_bytes characters, every term followed by its collation key unless it is its own key
+//   entries      entry_count entries, ANG_POL order
+//   by_pol       entry_count positions, POL_ANG order
+//   appendix     appendix_bytes the caller saved along, the dictionary keeps its perfect hashes there
+// The checksum covers everything after the header, padding included.
+
+struct snapshot_header
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;	//snapshot_byte_order as written by the saving machine
+	uint64_t entry_count;
+	uint64_t pool_bytes;
+	uint64_t pool_offset, entries_offset, by_pol_offset;
+	uint64_t appendix_offset, appendix_bytes;
+	uint64_t file_size;
+	uint64_t checksum;
+};
+
+static const char snapshot_magic[8] = { 'E', 'N', 'G', 'P', 'O', 'L', 'D', 'B' };
+static const uint32_t snapshot_version = 4;	//1 had no collation keys, 2 stored every key in another encoding, 3 had no appendix
+static const uint32_t snapshot_byte_order = 0x01020304;
+
+//------------------------------------------------------
+static size_t padded(size_t bytes)
+{
+	return (bytes + 7) / 8 * 8;
+}
+//------------------------------------------------------
+// multiply-xorshift over 8-byte words; data shorter than a whole word is padded with zeros
+static uint64_t checksum(const char* data, size_t bytes, uint64_t h)
+{
+	for (size_t i = 0; i < bytes; i += 8)
+	{
+		uint64_t w = 0;
+		memcpy(&w, data + i, min<size_t>(8, bytes - i));
+		h = (h ^ w) * 0x9e3779b97f4a7c15ull;
+		h ^= h >> 32;
+	}
+	return h;
+}
+//------------------------------------------------------
+bool word_store::save(const string& file_name, string_view appendix) const
+{
+	snapshot_header header{};
+	memcpy(header.magic, snapshot_magic, sizeof(snapshot_magic));
+	header.version = snapshot_version;
+	header.byte_order = snapshot_byte_order;
+	header.entry_count = size();
+
+	// the pool may hold characters no entry uses any more, only the used part is saved
+	for (size_t i = 0; i < size(); i++)
+		header.pool_bytes = max<uint64_t>(header.pool_bytes, entry_end(all_entries()[i]));
+
+	header.pool_offset = padded(sizeof(header));
+	header.entries_offset = header.pool_offset + padded(header.pool_bytes);
+	header.by_pol_offset = header.entries_offset + padded(size() * sizeof(entry));
+	header.appendix_offset = header.by_pol_offset + padded(size() * sizeof(uint32_t));
+	header.appendix_bytes = appendix.size();
+	header.file_size = header.appendix_offset + padded(appendix.size());
+
+	const char* sections[] = { chars(), (const char*)all_entries(), (const char*)pol_order(), appendix.data() };
+	const size_t lengths[] = { header.pool_bytes, size() * sizeof(entry), size() * sizeof(uint32_t), appendix.size() };
+
+	header.checksum = 0;
+	for (size_t i = 0; i < 4; i++)
+		header.checksum = checksum(sections[i], lengths[i], header.checksum);
+
+	// written next to the target and renamed over it, a process may still have the old file mapped
+	string temporary = file_name + ".tmp";
+	{
+		ofstream out(temporary, ios::binary | ios::trunc);
+		out.write((const char*)&header, sizeof(header));
+		const char zeros[8] = {};
+		out.write(zeros, padded(sizeof(header)) - sizeof(header));
+		for (size_t i = 0; i < 4; i++)
+		{
+			out.write(sections[i], lengths[i]);
+			out.write(zeros, padded(lengths[i]) - lengths[i]);
+		}
+		if (!out.good())
+		{
+			out.close();
+			remove(temporary.c_str());
+			return false;
+		}
+	}
+
+#ifdef _WIN32
+	remove(file_name.c_str());
+#endif
+	return rename(temporary.c_str(), file_name.c_str()) == 0;
+}
+//------------------------------------------------------
+bool word_store::load(const string& file_name, bool verify)
+{
+	auto file = make_shared<mapped_file>();
+	if (!file->open(file_name))
+		return false;
+
+	string_view data = file->contents();
+	snapshot_header header;
+	if (data.size() < sizeof(header))
+		return false;
+	memcpy(&header, data.data(), sizeof(header));
+
+	if (memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)) != 0 || header.version != snapshot_version
+		|| header.byte_order != snapshot_byte_order || header.file_size != data.size()
+		|| header.entry_count > UINT32_MAX || header.pool_bytes > UINT32_MAX
+		|| header.pool_offset != padded(sizeof(header))
+		|| header.entries_offset != header.pool_offset + padded(header.pool_bytes)
+		|| header.by_pol_offset != header.entries_offset + padded(header.entry_count * sizeof(entry))
+		|| header.appendix_offset != header.by_pol_offset + padded(header.entry_count * sizeof(uint32_t))
+		|| header.appendix_bytes > header.file_size
+		|| header.file_size != header.appendix_offset + padded(header.appendix_bytes))
+		return false;
+
+	// every view has to stay inside the mapping, checksum or not; this reads the entries and the Polish order
+	// but not the pool, which a checksum reads too
+	const char* base = data.data();
+	auto stored = (const entry*)(base + header.entries_offset);
+	auto positions = (const uint32_t*)(base + header.by_pol_offset);
+	for (size_t i = 0; i < header.entry_count; i++)
+		if (entry_end(stored[i]) > header.pool_bytes || positions[i] >= header.entry_count)
+			return false;
+
+	if (verify)
+	{
+		uint64_t h = 0;
+		h = checksum(base + header.pool_offset, header.pool_bytes, h);
+		h = checksum(base + header.entries_offset, header.entry_count * sizeof(entry), h);
+		h = checksum(base + header.by_pol_offset, header.entry_count * sizeof(uint32_t), h);
+		h = checksum(base + header.appendix_offset, header.appendix_bytes, h);
+		if (h != header.checksum)
+			return false;
+	}
+
+	snapshot = move(file);
+	mapped_pool = base + header.pool_offset;
+	mapped_entries = stored;
+	mapped_by_pol = positions;
+	mapped_count = header.entry_count;
+	mapped_appendix = string_view(base + header.appendix_offset, header.appendix_bytes);
+
+	pool.clear();
+	pool.shrink_to_fit();
+	entries = vector<entry>();
+	by_pol = vector<uint32_t>();
+	generation.value = generation_tag::next();
+	return true;
+}
+//------------------------------------------------------
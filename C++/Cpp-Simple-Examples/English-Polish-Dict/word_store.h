@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "criteria.h"
+#include "collation.h"
+#include "file_loader.h"
+
+using std::pair;
+using std::shared_ptr;
+using std::string;
+using std::string_view;
+using std::vector;
+
+
+enum class lang { ENG, POL };	//one side of the dictionary
+
+
+//one dictionary entry, both terms as offsets into the character pool;
+//every term is followed there by its collation key, which orders and identifies the entries,
+//unless the term is its own key (see collates_as_itself): then it is not stored and its length is 0
+struct entry
+{
+	uint32_t eng, pol;
+	uint16_t eng_len, eng_key_len;
+	uint16_t pol_len, pol_key_len;
+};
+
+
+//identifies the memory a store's views point into: a new value after every change,
+//and copies or moves get their own, since their characters live somewhere else
+struct generation_tag
+{
+	uint64_t value = next();
+
+	generation_tag() = default;
+	generation_tag(const generation_tag&) {}
+	generation_tag& operator=(const generation_tag&) { value = next(); return *this; }
+
+	static uint64_t next();
+};
+
+
+//arena-backed storage: every term's characters in one pool, fixed-size entries in one sorted vector.
+//Both orders compare collation keys, so entries differing only in case are the same entry.
+//A store loaded from a snapshot reads straight from the mapped file and copies it out on the first change
+class word_store
+{
+	string pool;				//characters of all terms and their keys, back to back
+	vector<entry> entries;		//ANG_POL order
+	vector<uint32_t> by_pol;	//positions in entries, POL_ANG order
+	generation_tag generation;	//for indexes built on top of the store
+
+	//a loaded snapshot, used instead of the three members above while it is set
+	shared_ptr<const mapped_file> snapshot;
+	const char* mapped_pool = nullptr;
+	const entry* mapped_entries = nullptr;
+	const uint32_t* mapped_by_pol = nullptr;
+	size_t mapped_count = 0;
+	string_view mapped_appendix;
+
+	const char* chars() const { return snapshot ? mapped_pool : pool.data(); }
+	const entry* all_entries() const { return snapshot ? mapped_entries : entries.data(); }
+	const uint32_t* pol_order() const { return snapshot ? mapped_by_pol : by_pol.data(); }
+	void make_writable();
+
+	uint32_t intern(string& to, string_view term, string_view key);
+
+public:
+	size_t size() const { return snapshot ? mapped_count : entries.size(); }
+	bool empty() const { return size() == 0; }
+	uint64_t version() const { return generation.value; }
+	bool is_mapped() const { return snapshot != nullptr; }
+
+	string_view eng(const entry& e) const { return string_view(chars() + e.eng, e.eng_len); }
+	string_view pol(const entry& e) const { return string_view(chars() + e.pol, e.pol_len); }
+	term_pair terms(const entry& e) const { return term_pair(eng(e), pol(e)); }
+	string_view eng_key(const entry& e) const { return e.eng_key_len ? string_view(chars() + e.eng + e.eng_len, e.eng_key_len) : eng(e); }
+	string_view pol_key(const entry& e) const { return e.pol_key_len ? string_view(chars() + e.pol + e.pol_len, e.pol_key_len) : pol(e); }
+	term_pair keys(const entry& e) const { return term_pair(eng_key(e), pol_key(e)); }
+
+	//entry at the given rank of either order, O(1)
+	const entry& at(Cmp::sort order, size_t rank) const
+	{
+		return order == Cmp::sort::ANG_POL ? all_entries()[rank] : all_entries()[pol_order()[rank]];
+	}
+
+	//merges a batch of pairs in with one sort, the views only have to stay valid during the call;
+	//a pair equal to a stored one up to case is dropped, the stored spelling stays
+	void build(vector<term_pair> pairs);
+	//adds a single pair, false if it was already there (up to case)
+	bool insert(string_view eng, string_view pol);
+	bool contains(string_view eng, string_view pol) const;
+
+	//every distinct spelling of one language with its collation key, in collation order
+	vector<pair<string_view, string_view>> terms_of(lang side) const;
+
+	//binary snapshot of the pool and both orders, see word_store.cpp for the layout;
+	//appendix is saved along with them for the indexes built on top of the store
+	bool save(const string& file_name, string_view appendix = {}) const;
+	//maps a snapshot and uses it in place of the current contents. Offsets and lengths are always checked to stay
+	//inside the file, a pass over the entries; verify checks the checksum too, which reads the whole file once
+	//but is the only way to notice changed characters or a broken order
+	bool load(const string& file_name, bool verify = true);
+	//the appendix of the mapped snapshot, empty once the store has changed
+	string_view appendix() const { return snapshot ? mapped_appendix : string_view(); }
+};
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "hanoi.h"
+#include "parallel.h"
+
+// Usage: HanoiBench [--min levels] [--max levels] [--reps n] [--budget seconds] [--variant name] [--towers stack|bitboard] [--out file.json]
+
+template<template<size_t> class towersT>
+struct solvers{
+    static void recursive(hanoi<3, towersT>& game) { game.playGame(true); }
+    static void nonRecursive(hanoi<3, towersT>& game) { game.playGame(false); }
+    static void mySolution(hanoi<3, towersT>& game) { game.playGameMySol(); }
+    static void bitwise(hanoi<3, towersT>& game) { game.playGameBitwise(); }
+
+    template<size_t levels>
+    static void table(hanoi<3, towersT>& game) { game.template playGameTable<levels>(); }
+
+    template<size_t pegs>
+    static void frameStewart(hanoi<pegs, towersT>& game) { game.playGameFrameStewart(); }
+};
+
+// Returns the wall time of one solve in ns, construction of the towers is not timed.
+template<size_t pegs, template<size_t> class towersT, void (*play)(hanoi<pegs, towersT>&)>
+static double timedRun(size_t towerLevels){
+    hanoi<pegs, towersT> game(towerLevels);
+
+    auto start = std::chrono::steady_clock::now();
+    play(game);
+    auto stop = std::chrono::steady_clock::now();
+
+    if (!game.isSolved()) [[unlikely]]
+        throw std::runtime_error("[ ERROR ] Solver left the towers unsolved\n");
+
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+// The table is a template argument, the one matching the run-time height is picked from all of them.
+template<template<size_t> class towersT, size_t... levels>
+static double timedTableRun(size_t towerLevels, std::index_sequence<levels...>){
+    static constexpr double (*runs[])(size_t) = { timedRun<3, towersT, solvers<towersT>::template table<levels + 1>>... };
+    return runs[towerLevels - 1](towerLevels);
+}
+
+template<template<size_t> class towersT>
+static double timedTableRun(size_t towerLevels){
+    return timedTableRun<towersT>(towerLevels, std::make_index_sequence<maxTableLevels>{});
+}
+
+static double timedParallelRun(size_t towerLevels){
+    auto start = std::chrono::steady_clock::now();
+    auto report = playGameParallel(towerLevels);
+    auto stop = std::chrono::steady_clock::now();
+
+    if (!report.valid) [[unlikely]]
+        throw std::runtime_error("[ ERROR ] Parallel run failed its consistency check\n");
+
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+struct variant{
+    const char* name;
+    const char* towers;
+    size_t pegs;
+    double (*run)(size_t);
+    size_t maxLevels = 64;
+};
+
+static const variant variants[] = {
+    { "recursive",    "stack",    3, timedRun<3, stackTowers, solvers<stackTowers>::recursive> },
+    { "nonRecursive", "stack",    3, timedRun<3, stackTowers, solvers<stackTowers>::nonRecursive> },
+    { "mySolution",   "stack",    3, timedRun<3, stackTowers, solvers<stackTowers>::mySolution> },
+    { "bitwise",      "stack",    3, timedRun<3, stackTowers, solvers<stackTowers>::bitwise> },
+    { "recursive",    "bitboard", 3, timedRun<3, bitboardTowers, solvers<bitboardTowers>::recursive> },
+    { "nonRecursive", "bitboard", 3, timedRun<3, bitboardTowers, solvers<bitboardTowers>::nonRecursive> },
+    { "mySolution",   "bitboard", 3, timedRun<3, bitboardTowers, solvers<bitboardTowers>::mySolution> },
+    { "bitwise",      "bitboard", 3, timedRun<3, bitboardTowers, solvers<bitboardTowers>::bitwise> },
+    { "table",        "stack",    3, timedTableRun<stackTowers>, maxTableLevels },
+    { "table",        "bitboard", 3, timedTableRun<bitboardTowers>, maxTableLevels },
+    { "parallel",     "bitboard", 3, timedParallelRun },
+    { "frameStewart", "stack",    4, timedRun<4, stackTowers, solvers<stackTowers>::frameStewart<4>> },
+    { "frameStewart", "bitboard", 4, timedRun<4, bitboardTowers, solvers<bitboardTowers>::frameStewart<4>> },
+    { "frameStewart", "bitboard", 5, timedRun<5, bitboardTowers, solvers<bitboardTowers>::frameStewart<5>> },
+};
+
+struct config{
+    size_t minLevels = 10;
+    size_t maxLevels = 32;
+    size_t reps = 15;
+    double budgetSec = 10.0; // per (variant, levels) pair, at least one run is always made
+    std::string variantName;
+    std::string towers;
+    std::string outPath = "hanoi_bench.json";
+};
+
+struct result{
+    const char* variantName;
+    const char* towers;
+    size_t pegs;
+    size_t towerLevels;
+    uint64_t moves;
+    std::vector<double> runsNs;
+    double minNs, medianNs, p99Ns;
+};
+
+static double percentile(const std::vector<double>& sorted, double p){
+    // nearest-rank, so the value is always one that was actually measured
+    auto rank = static_cast<size_t>(p / 100.0 * (double)sorted.size() + 0.999999);
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+static result measure(const variant& v, size_t towerLevels, const config& cfg){
+    result res{ v.name, v.towers, v.pegs, towerLevels, frameStewart::moveCount(towerLevels, v.pegs), {}, 0, 0, 0 };
+    double spentNs = 0;
+
+    while (res.runsNs.size() < cfg.reps && (res.runsNs.empty() || spentNs < cfg.budgetSec * 1e9)){
+        double ns = v.run(towerLevels);
+        res.runsNs.push_back(ns);
+        spentNs += ns;
+    }
+
+    auto sorted = res.runsNs;
+    std::sort(sorted.begin(), sorted.end());
+    res.minNs = sorted.front();
+    res.medianNs = percentile(sorted, 50);
+    res.p99Ns = percentile(sorted, 99);
+
+    return res;
+}
+
+static void writeJson(const std::vector<result>& results, const config& cfg){
+    std::ofstream out(cfg.outPath);
+    if (!out.good())
+        throw std::runtime_error("[ ERROR ] Cannot open " + cfg.outPath + "\n");
+
+    out << "{\n";
+#ifdef __VERSION__
+    out << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+#endif
+#ifdef NDEBUG
+    out << "  \"assertions\": false,\n";
+#else
+    out << "  \"assertions\": true,\n";
+#endif
+    out << "  \"timestamp\": " << std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count() << ",\n";
+    out << "  \"results\": [\n";
+
+    for (size_t i = 0; i < results.size(); ++i){
+        const auto& r = results[i];
+        out << "    { \"variant\": \"" << r.variantName << "\", \"towers\": \"" << r.towers
+            << "\", \"pegs\": " << r.pegs << ", \"levels\": " << r.towerLevels
+            << ", \"moves\": " << r.moves << ", \"runs\": " << r.runsNs.size()
+            << ", \"minNs\": " << r.minNs << ", \"medianNs\": " << r.medianNs << ", \"p99Ns\": " << r.p99Ns
+            << ", \"nsPerMove\": " << r.medianNs / (double)r.moves
+            << ", \"movesPerSec\": " << (double)r.moves / (r.medianNs * 1e-9) << " }"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+
+    out << "  ]\n}\n";
+}
+
+static config parseArgs(int argc, char** argv){
+    config cfg;
+
+    for (int i = 1; i + 1 < argc; i += 2){
+        if (!std::strcmp(argv[i], "--min")) cfg.minLevels = std::stoul(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--max")) cfg.maxLevels = std::stoul(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--reps")) cfg.reps = std::max<size_t>(1, std::stoul(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--budget")) cfg.budgetSec = std::stod(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--variant")) cfg.variantName = argv[i + 1];
+        else if (!std::strcmp(argv[i], "--towers")) cfg.towers = argv[i + 1];
+        else if (!std::strcmp(argv[i], "--out")) cfg.outPath = argv[i + 1];
+        else throw std::invalid_argument(std::string("[ ERROR ] Unknown option ") + argv[i] + "\n");
+    }
+
+    return cfg;
+}
+
+int main(int argc, char** argv) try {
+    auto cfg = parseArgs(argc, argv);
+    std::vector<result> results;
+
+    std::printf("%-14s %-9s %4s %6s %6s %14s %14s %14s %10s %14s\n",
+                "variant", "towers", "pegs", "levels", "runs", "min [ms]", "median [ms]", "p99 [ms]", "ns/move", "moves/s");
+
+    for (size_t towerLevels = cfg.minLevels; towerLevels <= cfg.maxLevels; ++towerLevels){
+        for (const auto& v : variants){
+            if (!cfg.variantName.empty() && cfg.variantName != v.name)
+                continue;
+            if (!cfg.towers.empty() && cfg.towers != v.towers)
+                continue;
+            if (towerLevels > v.maxLevels)
+                continue;
+
+            const auto& r = results.emplace_back(measure(v, towerLevels, cfg));
+            std::printf("%-14s %-9s %4zu %6zu %6zu %14.3f %14.3f %14.3f %10.3f %14.4g\n",
+                        r.variantName, r.towers, r.pegs, r.towerLevels, r.runsNs.size(), r.minNs * 1e-6, r.medianNs * 1e-6,
+                        r.p99Ns * 1e-6, r.medianNs / (double)r.moves, (double)r.moves / (r.medianNs * 1e-9));
+            std::fflush(stdout);
+        }
+    }
+
+    writeJson(results, cfg);
+    return 0;
+}
+catch (const std::exception& e){
+    std::cerr << e.what();
+    return 1;
+}
@@ -0,0 +1,84 @@
+#ifndef HANOI_BITBOARD_H
+#define HANOI_BITBOARD_H
+
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+
+#include "moves.h"
+#include "state.h"
+
+// State backend keeping one occupancy mask per peg, bit i set means disc of size i + 1 lies there.
+// The top disc of a peg is its lowest set bit, so a move is a single isolate and two XORs.
+template<size_t towersCount = 3>
+class bitboardTowers{
+public:
+    using dtype = uint;
+    static const int count = towersCount;
+    static const size_t maxLevels = 64;
+
+    explicit bitboardTowers(size_t towerLevels){
+        if (towerLevels > maxLevels) [[unlikely]]
+            throw std::out_of_range("[ ERROR ] Bitboard towers hold at most 64 discs\n");
+
+        _masks[0] = towerLevels == maxLevels ? UINT64_MAX : (uint64_t{ 1 } << towerLevels) - 1;
+    }
+
+    // Towers with disc d on peg pegs[d - 1].
+    explicit bitboardTowers(const towerConfig& pegs): bitboardTowers(pegs.size()){
+        validatePegs(pegs, count);
+
+        _masks[0] = 0;
+        for (size_t d = 1; d <= pegs.size(); ++d)
+            _masks[pegs[d - 1]] |= uint64_t{ 1 } << (d - 1);
+    }
+
+    // State after the first k moves of the optimal solution, computed without replaying them.
+    static bitboardTowers afterMoves(size_t towerLevels, uint64_t k) requires (towersCount == 3){
+        bitboardTowers towers(towerLevels);
+        towers._masks[0] = 0;
+
+        for (size_t d = 1; d <= towerLevels; ++d)
+            towers._masks[discPegAfter(towerLevels, d, k)] |= uint64_t{ 1 } << (d - 1);
+
+        return towers;
+    }
+
+    void move(size_t src, size_t dst){
+        auto disc = _masks[src] & -_masks[src];
+        _masks[src] ^= disc;
+        _masks[dst] ^= disc;
+    }
+
+    [[nodiscard]] size_t height(size_t tower) const{
+        return std::popcount(_masks[tower]);
+    }
+
+    // Writes the discs of a tower bottom to top, returns how many were written.
+    size_t fillColumn(size_t tower, dtype* out) const{
+        size_t used = height(tower);
+
+        size_t i = used;
+        for (auto mask = _masks[tower]; mask; mask &= mask - 1)
+            out[--i] = std::countr_zero(mask) + 1;
+
+        return used;
+    }
+
+    [[nodiscard]] uint64_t mask(size_t tower) const { return _masks[tower]; }
+
+    // Whether moving the top disc of src onto dst is legal.
+    [[nodiscard]] bool canMove(size_t src, size_t dst) const{
+        auto disc = _masks[src] & -_masks[src];
+        auto below = _masks[dst] & -_masks[dst];
+
+        return disc != 0 && (below == 0 || disc < below);
+    }
+
+    friend bool operator==(const bitboardTowers&, const bitboardTowers&) = default;
+
+private:
+    uint64_t _masks[count] = {};
+};
+
+#endif //HANOI_BITBOARD_H
@@ -0,0 +1,159 @@
+#ifndef HANOI_CONFIGSOLVER_H
+#define HANOI_CONFIGSOLVER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "moves.h"
+#include "state.h"
+#include "threadPool.h"
+
+// Shortest paths between any two legal 3-peg layouts.
+// Discs larger than every misplaced one never move. The largest
+// disc d that has to move either goes straight from s to g (the smaller ones wait on the third peg),
+// or goes s -> t -> g while the smaller ones pass as a perfect tower from g to s in between;
+// the shorter of the two is optimal. Moving discs 1..m of a layout onto one peg is computed largest
+// disc first as well: a disc already on the target keeps it, otherwise the smaller ones are
+// gathered on the third peg, the disc moves, and a perfect tower of 2^(m-1) - 1 moves follows.
+
+struct configQuery{
+    towerConfig start;
+    towerConfig goal;
+};
+
+namespace configSolver{
+    inline uint8_t thirdPeg(uint8_t a, uint8_t b) { return static_cast<uint8_t>(3 - a - b); }
+
+    inline uint64_t saturatingAdd(uint64_t a, uint64_t b) { return a > UINT64_MAX - b ? UINT64_MAX : a + b; }
+
+    inline void validate(const towerConfig& start, const towerConfig& goal){
+        if (start.size() != goal.size() || start.size() > 64) [[unlikely]]
+            throw std::invalid_argument("[ ERROR ] Start and goal need the same number of discs (at most 64)\n");
+
+        for (size_t i = 0; i < start.size(); ++i)
+            if (start[i] > 2 || goal[i] > 2) [[unlikely]]
+                throw std::invalid_argument("[ ERROR ] Layouts may only use pegs 0, 1 and 2\n");
+    }
+
+    // Moves needed to gather discs 1..discs of the layout on peg.
+    inline uint64_t gatherCount(const towerConfig& pegs, size_t discs, uint8_t peg){
+        uint64_t moves = 0;
+
+        for (size_t d = discs; d > 0; --d){
+            if (pegs[d - 1] == peg) continue;
+
+            moves += uint64_t{ 1 } << (d - 1);
+            peg = thirdPeg(pegs[d - 1], peg);
+        }
+
+        return moves;
+    }
+
+    inline void perfectTower(size_t discs, uint8_t src, uint8_t tmp, uint8_t dst, std::vector<hanoiMove>& out){
+        const uint8_t label[3] = { src, tmp, dst };
+        for (auto [s, d] : hanoiMoves(discs))
+            out.push_back({ label[s], label[d] });
+    }
+
+    inline void gatherMoves(const towerConfig& pegs, size_t discs, uint8_t peg, std::vector<hanoiMove>& out){
+        while (discs > 0 && pegs[discs - 1] == peg)
+            --discs;
+        if (discs == 0) return;
+
+        uint8_t from = pegs[discs - 1];
+        uint8_t spare = thirdPeg(from, peg);
+
+        gatherMoves(pegs, discs - 1, spare, out);
+        out.push_back({ from, peg });
+        perfectTower(discs - 1, spare, from, peg, out);
+    }
+
+    // The reverse of gathering the goal: from a perfect tower of discs 1..discs on peg to the goal layout.
+    inline void scatterMoves(const towerConfig& goal, size_t discs, uint8_t peg, std::vector<hanoiMove>& out){
+        size_t first = out.size();
+        gatherMoves(goal, discs, peg, out);
+
+        std::reverse(out.begin() + first, out.end());
+        for (auto it = out.begin() + first; it != out.end(); ++it)
+            std::swap(it->src, it->dst);
+    }
+
+    // Largest disc whose peg differs, 0 when the layouts are equal.
+    inline size_t largestMisplaced(const towerConfig& start, const towerConfig& goal){
+        size_t d = start.size();
+        while (d > 0 && start[d - 1] == goal[d - 1])
+            --d;
+
+        return d;
+    }
+}
+
+// Length of the shortest path between two layouts, in O(n).
+inline uint64_t minMovesBetween(const towerConfig& start, const towerConfig& goal){
+    using namespace configSolver;
+    validate(start, goal);
+
+    size_t d = largestMisplaced(start, goal);
+    if (d == 0) return 0;
+
+    uint8_t s = start[d - 1], g = goal[d - 1], t = thirdPeg(s, g);
+
+    uint64_t direct = saturatingAdd(gatherCount(start, d - 1, t) + 1, gatherCount(goal, d - 1, t));
+    uint64_t viaThird = saturatingAdd(saturatingAdd(gatherCount(start, d - 1, g), uint64_t{ 1 } << (d - 1)),
+                                      saturatingAdd(gatherCount(goal, d - 1, s), 1));
+
+    return std::min(direct, viaThird);
+}
+
+// The moves of a shortest path between two layouts.
+inline std::vector<hanoiMove> solveBetween(const towerConfig& start, const towerConfig& goal){
+    using namespace configSolver;
+
+    const uint64_t best = minMovesBetween(start, goal);
+    std::vector<hanoiMove> moves;
+    moves.reserve(best);
+
+    size_t d = largestMisplaced(start, goal);
+    if (d == 0) return moves;
+
+    uint8_t s = start[d - 1], g = goal[d - 1], t = thirdPeg(s, g);
+
+    uint64_t direct = saturatingAdd(gatherCount(start, d - 1, t) + 1, gatherCount(goal, d - 1, t));
+    if (direct == best){
+        gatherMoves(start, d - 1, t, moves);
+        moves.push_back({ s, g });
+        scatterMoves(goal, d - 1, t, moves);
+    }
+    else{
+        gatherMoves(start, d - 1, g, moves);
+        moves.push_back({ s, t });
+        perfectTower(d - 1, g, t, s, moves);
+        moves.push_back({ t, g });
+        scatterMoves(goal, d - 1, s, moves);
+    }
+
+    return moves;
+}
+
+// Independent queries spread over the pool, results in query order.
+inline std::vector<uint64_t> minMovesBatch(const std::vector<configQuery>& queries, threadPool& pool){
+    std::vector<uint64_t> ret(queries.size());
+    pool.parallelFor(queries.size(), [&](size_t i){
+        ret[i] = minMovesBetween(queries[i].start, queries[i].goal);
+    });
+
+    return ret;
+}
+
+inline std::vector<std::vector<hanoiMove>> solveBatch(const std::vector<configQuery>& queries, threadPool& pool){
+    std::vector<std::vector<hanoiMove>> ret(queries.size());
+    pool.parallelFor(queries.size(), [&](size_t i){
+        ret[i] = solveBetween(queries[i].start, queries[i].goal);
+    }, 16);
+
+    return ret;
+}
+
+#endif //HANOI_CONFIGSOLVER_H
@@ -0,0 +1,76 @@
+#ifndef HANOI_FRAMESTEWART_H
+#define HANOI_FRAMESTEWART_H
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "moves.h"
+
+// Frame-Stewart recursion for p >= 4 pegs: park the top k discs on a spare peg using all p pegs,
+// move the remaining n - k with p - 1 pegs, then bring the k discs back on top.
+// The optimal k per (pegs, discs) is memoized in one table shared by every solve.
+class frameStewart{
+public:
+    struct entry{
+        uint64_t moves;
+        size_t split;
+    };
+
+    // table[p][n] for 3 <= p <= pegs and n <= discs.
+    using table = std::vector<std::vector<entry>>;
+
+    static table splits(size_t discs, size_t pegs){
+        std::lock_guard lock(_mutex);
+        grow(discs, pegs);
+
+        table ret(pegs + 1);
+        for (size_t p = 3; p <= pegs; ++p)
+            ret[p].assign(_table[p].begin(), _table[p].begin() + discs + 1);
+
+        return ret;
+    }
+
+    static uint64_t moveCount(size_t discs, size_t pegs){
+        std::lock_guard lock(_mutex);
+        grow(discs, pegs);
+
+        return _table[pegs][discs].moves;
+    }
+
+private:
+    static uint64_t saturatingAdd(uint64_t a, uint64_t b){
+        return a > UINT64_MAX - b ? UINT64_MAX : a + b;
+    }
+
+    static void grow(size_t discs, size_t pegs){
+        if (_table.size() <= pegs)
+            _table.resize(pegs + 1);
+
+        for (size_t p = 3; p <= pegs; ++p){
+            auto& row = _table[p];
+
+            for (size_t n = row.size(); n <= discs; ++n){
+                if (p == 3 || n <= 1){
+                    row.push_back({ ::moveCount(n), n == 0 ? 0 : n - 1 });
+                    continue;
+                }
+
+                entry best{ UINT64_MAX, 1 };
+                for (size_t k = 1; k < n; ++k){
+                    auto moves = saturatingAdd(saturatingAdd(row[k].moves, row[k].moves), _table[p - 1][n - k].moves);
+                    if (moves < best.moves)
+                        best = { moves, k };
+                }
+
+                row.push_back(best);
+            }
+        }
+    }
+
+    inline static std::mutex _mutex;
+    inline static table _table;
+};
+
+#endif //HANOI_FRAMESTEWART_H
@@ -1,86 +1,185 @@
 #ifndef HANOI_HANOI_H
 #define HANOI_HANOI_H
 
+#include <bit>
+#include <vector>
+
+#include "bitboard.h"
+#include "configSolver.h"
+#include "frameStewart.h"
+#include "moves.h"
+#include "renderer.h"
 #include "stack.h"
+#include "state.h"
+#include "table.h"
+#include "towers.h"
 
+template<size_t pegCount = 3, template<size_t> class towersT = stackTowers>
 class hanoi{
+    static_assert(pegCount >= 3 && pegCount <= 32, "hanoi needs between 3 and 32 pegs");
+
 public:
-    using dtype = uint;
+    using towers = towersT<pegCount>;
+    using dtype = typename towers::dtype;
 
-    explicit hanoi(size_t towerLevels): _towerLevels{ towerLevels }{
-        for(auto& tower : _towers){
-            tower = new stack<dtype>(towerLevels);
-        }
+    explicit hanoi(size_t towerLevels): _towers{ towerLevels }, _towerLevels{ towerLevels } {}
 
-        for(dtype i = towerLevels; i > 0; --i)
-            _towers[0]->push(i);
+    // Resumes from any layout, e.g. stateAfterMove(levels, k) of a checkpointed run.
+    explicit hanoi(const towerConfig& pegs): _towers{ pegs }, _towerLevels{ pegs.size() } {}
+
+    // Frames are drawn by the renderer, which may throttle them (see frameRenderer::setMaxFps).
+    void displayTowers(){
+        if (_renderer.frameDue())
+            drawTowers();
     }
 
-    ~hanoi(){
-        for(auto& tower : _towers){
-            delete tower;
+    frameRenderer& renderer() { return _renderer; }
+
+    [[nodiscard]] towerConfig state() const{
+        std::vector<dtype> column(_towerLevels);
+        towerConfig pegs(_towerLevels);
+
+        for (size_t i = 0; i < towersCount; ++i){
+            size_t height = _towers.fillColumn(i, column.data());
+            for (size_t j = 0; j < height; ++j)
+                pegs[column[j] - 1] = i;
         }
+
+        return pegs;
     }
 
-    void displayTowers(){
-        std::tuple<const dtype*, size_t> towerArrays[towersCount];
+    // A single move checked against the rules, false (and nothing moved) when it breaks them.
+    bool playMove(size_t srcTower, size_t dstTower){
+        if (srcTower >= towersCount || dstTower >= towersCount || srcTower == dstTower || !_towers.canMove(srcTower, dstTower))
+            return false;
 
-        for (size_t i = 0; i < towersCount; ++i)
-            towerArrays[i] = _towers[i]->getUnderlyingData();
+        _towers.move(srcTower, dstTower);
+        return true;
+    }
+
+    [[nodiscard]] bool isSolved() const{
+        return _towers.height(towersCount - 1) == _towerLevels;
+    }
+
+    template<bool showEveryMove = false>
+    void playGame(bool isRecursive = true) requires (pegCount == 3)
+    {
+        if constexpr (showEveryMove)
+            displayTowers();
 
-        for(size_t i = _towerLevels; i > 0 ; --i){
-            std::cout << "  ";
+        if (isRecursive) hanoiRecu<showEveryMove>(_towerLevels, 0, 1, 2);
+        else hanoiNonRecu<showEveryMove>();
 
-            for(size_t j = 0; j < towersCount - 1; ++j){
-                if (std::get<1>(towerArrays[j]) >= i )
-                    std::cout << std::get<0>(towerArrays[j])[i - 1];
-                else
-                    std::cout << '|';
+        if constexpr (showEveryMove)
+            finishDisplay();
+    }
 
-                std::cout << "     ";
-            }
+    template<bool showEveryMove = false>
+    void playGameMySol() requires (pegCount == 3)
+    {
+        if constexpr (showEveryMove)
+            displayTowers();
 
-            if (std::get<1>(towerArrays[2]) >= i )
-                std::cout << std::get<0>(towerArrays[2])[i - 1];
-            else
-                std::cout << '|';
+        hanoiMyNonRecu<showEveryMove>();
+
+        if constexpr (showEveryMove)
+            finishDisplay();
+    }
+
+    // firstMove skips that many moves of the solution, so a game built from
+    // stateAfterMove(levels, firstMove) picks up exactly where the checkpoint was taken.
+    template<bool showEveryMove = false>
+    void playGameBitwise(uint64_t firstMove = 0) requires (pegCount == 3)
+    {
+        if constexpr (showEveryMove)
+            displayTowers();
+
+        hanoiBitwise<showEveryMove>(firstMove);
+
+        if constexpr (showEveryMove)
+            finishDisplay();
+    }
 
-            std::cout << "     \n";
+    template<size_t towerLevels, bool showEveryMove = false>
+    void playGameTable() requires (pegCount == 3)
+    {
+        if (towerLevels != _towerLevels) [[unlikely]]
+            throw std::invalid_argument("[ ERROR ] Solution table does not match the tower height\n");
+
+        if constexpr (showEveryMove)
+            displayTowers();
+
+        for (auto code : solutionTable<towerLevels>::moves)
+        {
+            auto [src, dst] = decodeMove(code);
+            _towers.move(src, dst);
+
+            if constexpr (showEveryMove)
+                displayTowers();
         }
 
-        std::cout << "_____ _____ _____\n";
+        if constexpr (showEveryMove)
+            finishDisplay();
     }
 
+    // Shortest path from the current layout to any other one.
     template<bool showEveryMove = false>
-    void playGame(bool isRecursive = true)
+    void playGameTo(const towerConfig& goal) requires (pegCount == 3)
     {
         if constexpr (showEveryMove)
             displayTowers();
 
-        if (isRecursive) hanoiRecu<showEveryMove>(_towerLevels, 0, 1, 2);
-        else hanoiNonRecu<showEveryMove>();
+        for (auto [src, dst] : solveBetween(state(), goal))
+        {
+            _towers.move(src, dst);
+
+            if constexpr (showEveryMove)
+                displayTowers();
+        }
+
+        if constexpr (showEveryMove)
+            finishDisplay();
     }
 
+    // Optimal for 3 pegs and the presumed optimum (Frame-Stewart) for more.
     template<bool showEveryMove = false>
-    void playGameMySol()
+    void playGameFrameStewart()
     {
         if constexpr (showEveryMove)
             displayTowers();
 
-        hanoiMyNonRecu<showEveryMove>();
+        auto spareTowers = static_cast<uint32_t>((uint64_t{ 1 } << (towersCount - 1)) - 2);
+        hanoiFrameStewart<showEveryMove>(frameStewart::splits(_towerLevels, towersCount), _towerLevels, 0, towersCount - 1, spareTowers);
+
+        if constexpr (showEveryMove)
+            finishDisplay();
     }
 
 private:
 
+    void drawTowers(){
+        _columns.resize(towersCount * _towerLevels);
+        size_t heights[towersCount];
+
+        for (size_t i = 0; i < towersCount; ++i)
+            heights[i] = _towers.fillColumn(i, _columns.data() + i * _towerLevels);
+
+        _renderer.draw(_columns.data(), heights, towersCount, _towerLevels);
+    }
+
+    // The final layout is always shown, even if throttling dropped its frame.
+    void finishDisplay(){
+        if (_renderer.hasSkippedFrame())
+            drawTowers();
+    }
+
     template<bool showEveryMove = false>
     void hanoiRecu(size_t elemsToMove, size_t srcTower, size_t tmpTower, size_t dstTower)
     {
         if (elemsToMove <= 0) return;
         hanoiRecu<showEveryMove>(elemsToMove - 1, srcTower, dstTower, tmpTower);
 
-        auto elem = _towers[srcTower]->top();
-        _towers[srcTower]->pop();
-        _towers[dstTower]->push(elem);
+        _towers.move(srcTower, dstTower);
 
         if constexpr (showEveryMove)
             displayTowers();
@@ -97,7 +196,7 @@ private:
         size_t tmpTower = 1;
         size_t dstTower = 2;
 
-        static const auto pop4 = [&]() -> void
+        auto pop4 = [&]() -> void
         {
             dstTower = argHolder.topNPop();
             tmpTower = argHolder.topNPop();
@@ -105,7 +204,7 @@ private:
             elemsToMove = argHolder.topNPop();
         };
 
-        static const auto push4 = [&]() -> void
+        auto push4 = [&]() -> void
         {
             argHolder.push(elemsToMove);
             argHolder.push(srcTower);
@@ -113,10 +212,9 @@ private:
             argHolder.push(dstTower);
         };
 
-        static const auto move = [&](size_t src, size_t dst) -> void
+        auto move = [&](size_t src, size_t dst) -> void
         {
-            auto ret = _towers[src]->topNPop();
-            _towers[dst]->push(ret);
+            _towers.move(src, dst);
         };
 
         while (elemsToMove > 0)
@@ -166,8 +264,7 @@ adrRet:     pop4();
 
        auto move = [&](size_t src, size_t dst) -> void
         {
-            auto ret = _towers[src]->topNPop();
-            _towers[dst]->push(ret);
+            _towers.move(src, dst);
         };
 
         while (elemsToMove > 0)
@@ -189,11 +286,97 @@ adrRet:     pop4();
         }
     }
 
+    template<bool showEveryMove = false>
+    void hanoiBitwise(uint64_t firstMove)
+    {
+        // The walk of hanoiMoves, unrolled by pairs: every odd move is the smallest disc taking one
+        // step, every even move k is disc countr_zero(k) + 1 taking one step in its own direction.
+        // All pegs stay in locals, so nothing has to be reloaded after a move.
+        constexpr uint32_t nextPeg[2][3] = { { 2, 0, 1 }, { 1, 2, 0 } };
+        const uint64_t last = moveCount(_towerLevels);
+
+        uint32_t discPeg[64] = {};
+        uint64_t forward = 0;
+        for (size_t d = 1; d <= _towerLevels && d <= 64; ++d){
+            discPeg[d - 1] = discPegAfter(_towerLevels, d, firstMove);
+            if ((_towerLevels - d) % 2) forward |= uint64_t{ 1 } << (d - 1);
+        }
+
+        const uint32_t* smallStep = nextPeg[forward & 1];
+        uint32_t small = discPeg[0];
+
+        auto play = [&](uint32_t src, uint32_t dst) -> void
+        {
+            _towers.move(src, dst);
+
+            if constexpr (showEveryMove)
+                displayTowers();
+        };
+
+        uint64_t k = firstMove + 1;
+        if (k <= last && k % 2 == 0){
+            auto disc = std::countr_zero(k);
+            uint32_t src = discPeg[disc];
+            discPeg[disc] = nextPeg[forward >> disc & 1][src];
+            play(src, discPeg[disc]);
+            ++k;
+        }
+
+        // k is odd here, the last move (2^n - 1) is odd as well
+        for (; k < last; k += 2)
+        {
+            uint32_t to = smallStep[small];
+            play(small, to);
+            small = to;
+
+            auto disc = std::countr_zero(k + 1);
+            uint32_t src = discPeg[disc];
+            discPeg[disc] = nextPeg[forward >> disc & 1][src];
+            play(src, discPeg[disc]);
+        }
+
+        if (k == last && last != 0)
+            play(small, smallStep[small]);
+    }
+
+    // spareTowers is a bitmask of the pegs this subproblem may use besides src and dst.
+    // Once a single spare is left the subtower is moved by the stackless 3-peg move loop.
+    template<bool showEveryMove = false>
+    void hanoiFrameStewart(const frameStewart::table& splits, size_t elemsToMove, size_t srcTower, size_t dstTower, uint32_t spareTowers)
+    {
+        if (elemsToMove == 0) return;
+
+        size_t pegs = std::popcount(spareTowers) + 2;
+        size_t tmpTower = std::countr_zero(spareTowers);
+
+        if (pegs == 3 || elemsToMove == 1)
+        {
+            const size_t label[3] = { srcTower, tmpTower, dstTower };
+            for (auto [src, dst] : hanoiMoves(elemsToMove))
+            {
+                _towers.move(label[src], label[dst]);
+
+                if constexpr (showEveryMove)
+                    displayTowers();
+            }
+            return;
+        }
+
+        size_t parked = splits[pegs][elemsToMove].split;
+        uint32_t otherSpares = spareTowers & ~(uint32_t{ 1 } << tmpTower);
+
+        hanoiFrameStewart<showEveryMove>(splits, parked, srcTower, tmpTower, otherSpares | uint32_t{ 1 } << dstTower);
+        hanoiFrameStewart<showEveryMove>(splits, elemsToMove - parked, srcTower, dstTower, otherSpares);
+        hanoiFrameStewart<showEveryMove>(splits, parked, tmpTower, dstTower, otherSpares | uint32_t{ 1 } << srcTower);
+    }
+
 public:
-    static const int towersCount = 3;
+    static const int towersCount = pegCount;
 private:
-    stack<dtype>* _towers[towersCount];
+    towers _towers;
     size_t _towerLevels;
+    frameRenderer _renderer;
+    std::vector<dtype> _columns;
 };
 
 #endif //HANOI_HANOI_H
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "hanoi.h"
-#include "timer.h"
+#include "parallel.h"
+#include "profiler.h"
 
 // parameters
 const size_t towerLevels = 20;
@@ -9,25 +10,62 @@ const bool displayTowers = false;
 const bool timeRecu = false; // standard recursive solution
 const bool timeNonRecu = false; // standard non-recursive solution
 const bool timerMyNonRecu = false; // improved non-recursive solution
+const bool timeBitwise = false; // stackless closed-form solution
+const bool timeBitboard = false; // closed-form solution on bitboard towers
+const bool timeTable = false; // replay of the compile-time table, which stops at maxTableLevels
+const bool timeParallel = false; // closed-form solution split across all cores
+const bool timeFrameStewart = false; // Frame-Stewart solution on 4 pegs
 const bool timeAll = true;
 
 int main() {
+    profileScope total("hanoi");
+
     if constexpr (timeRecu || timeAll){
         hanoi game(towerLevels);
-        timer t;
+        profileScope scope("recursive");
         game.playGame<displayTowers>(true);
     }
 
     if constexpr (timeNonRecu || timeAll){
         hanoi game(towerLevels);
-        timer t;
+        profileScope scope("nonRecursive");
         game.playGame<displayTowers>(false);
     }
 
     if constexpr (timerMyNonRecu || timeAll){
         hanoi game(towerLevels);
-        timer t;
+        profileScope scope("mySolution");
         game.playGameMySol<displayTowers>();
     }
 
+    if constexpr (timeBitwise || timeAll){
+        hanoi game(towerLevels);
+        profileScope scope("bitwise");
+        game.playGameBitwise<displayTowers>();
+    }
+
+    if constexpr (timeBitboard || timeAll){
+        hanoi<3, bitboardTowers> game(towerLevels);
+        profileScope scope("bitboard");
+        game.playGameBitwise<displayTowers>();
+    }
+
+    if constexpr (timeTable || timeAll){
+        hanoi game(maxTableLevels);
+        profileScope scope("table");
+        game.playGameTable<maxTableLevels, displayTowers>();
+    }
+
+    if constexpr (timeParallel || timeAll){
+        profileScope scope("parallel");
+        if (!playGameParallel(towerLevels).valid)
+            std::cout << "Parallel run failed its consistency check\n";
+    }
+
+    if constexpr (timeFrameStewart || timeAll){
+        hanoi<4, bitboardTowers> game(towerLevels);
+        profileScope scope("frameStewart4");
+        game.playGameFrameStewart<displayTowers>();
+    }
+
 }
\ No newline at end of file
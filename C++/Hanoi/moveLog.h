@@ -0,0 +1,345 @@
+#ifndef HANOI_MOVELOG_H
+#define HANOI_MOVELOG_H
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include "hanoi.h"
+#include "moves.h"
+
+// Binary log of a 3-peg solution. Each move is one of the six src -> dst pairs and takes 3 bits,
+// eight moves are packed into 3 bytes. The file is a 4 KiB header block followed by the packed moves.
+
+struct moveLogHeader{
+    char magic[8];
+    uint32_t version;
+    uint32_t towerLevels;
+    uint64_t moves;
+};
+
+constexpr char moveLogMagic[8] = { 'H', 'A', 'N', 'O', 'I', 'L', 'O', 'G' };
+constexpr uint32_t moveLogVersion = 1;
+constexpr size_t moveLogDataOffset = 4096;
+
+// 0: 0->1, 1: 0->2, 2: 1->0, 3: 1->2, 4: 2->0, 5: 2->1
+constexpr uint8_t encodeLogMove(hanoiMove move){
+    return static_cast<uint8_t>(move.src * 2 + (move.dst > move.src ? move.dst - 1 : move.dst));
+}
+
+constexpr hanoiMove decodeLogMove(uint8_t code){
+    auto src = static_cast<uint8_t>(code / 2);
+    auto rest = static_cast<uint8_t>(code % 2);
+
+    return { src, static_cast<uint8_t>(rest < src ? rest : rest + 1) };
+}
+
+// Packs moves on the calling thread and leaves the file I/O to a background thread, the two swap
+// between a pair of page-aligned buffers. With direct = true the file is opened with O_DIRECT
+// (falling back to buffered I/O where the filesystem refuses it).
+class moveLogWriter{
+public:
+    moveLogWriter(const std::string& path, size_t towerLevels, bool direct = false, size_t bufferBytes = size_t{ 24 } << 20)
+        : _towerLevels{ towerLevels }
+    {
+        // whole groups of 3 bytes and whole pages, so every full buffer is a valid O_DIRECT write
+        const size_t unit = 3 * moveLogDataOffset;
+        _bufferBytes = std::max(unit, bufferBytes / unit * unit);
+
+        _fd = openLog(path, direct);
+        for (auto& buffer : _buffers){
+            buffer = static_cast<uint8_t*>(std::aligned_alloc(moveLogDataOffset, _bufferBytes));
+            if (!buffer) [[unlikely]]{
+                release();
+                throw std::bad_alloc();
+            }
+        }
+
+        _ioThread = std::thread([this]{ ioLoop(); });
+    }
+
+    ~moveLogWriter(){
+        if (!_finished){
+            try { finish(); }
+            catch (...) {}
+        }
+    }
+
+    moveLogWriter(const moveLogWriter&) = delete;
+    moveLogWriter& operator=(const moveLogWriter&) = delete;
+
+    void append(hanoiMove move){
+        _pending |= uint32_t{ encodeLogMove(move) } << (3 * _pendingCount);
+        ++_moves;
+
+        if (++_pendingCount == 8)
+            flushPending();
+    }
+
+    // Writes out everything that is left and the header, the log is complete only after this.
+    void finish(){
+        if (_finished) return;
+        _finished = true;
+
+        if (_pendingCount > 0)
+            flushPending();
+        if (_used > 0)
+            submit();
+
+        {
+            std::unique_lock lock(_mutex);
+            _cv.wait(lock, [this]{ return !_busy; });
+            _stop = true;
+        }
+        _cv.notify_all();
+        _ioThread.join();
+
+        moveLogHeader header{};
+        std::memcpy(header.magic, moveLogMagic, sizeof(moveLogMagic));
+        header.version = moveLogVersion;
+        header.towerLevels = static_cast<uint32_t>(_towerLevels);
+        header.moves = _moves;
+
+        auto* block = _buffers[0];
+        std::memset(block, 0, moveLogDataOffset);
+        std::memcpy(block, &header, sizeof(header));
+
+        if (_error == 0 && pwrite(_fd, block, moveLogDataOffset, 0) != static_cast<ssize_t>(moveLogDataOffset))
+            _error = errno;
+
+        int error = _error;
+        release();
+
+        if (error != 0) [[unlikely]]
+            throw std::runtime_error(std::string("[ ERROR ] Move log write failed: ") + std::strerror(error) + "\n");
+    }
+
+    [[nodiscard]] uint64_t moves() const { return _moves; }
+
+private:
+    static int openLog(const std::string& path, bool direct){
+        int flags = O_WRONLY | O_CREAT | O_TRUNC;
+        int fd = -1;
+
+#ifdef O_DIRECT
+        if (direct)
+            fd = open(path.c_str(), flags | O_DIRECT, 0644);
+#endif
+        if (fd < 0)
+            fd = open(path.c_str(), flags, 0644);
+
+        if (fd < 0) [[unlikely]]
+            throw std::runtime_error("[ ERROR ] Cannot open " + path + ": " + std::strerror(errno) + "\n");
+
+        return fd;
+    }
+
+    void flushPending(){
+        auto* out = _buffers[_active] + _used;
+        out[0] = static_cast<uint8_t>(_pending);
+        out[1] = static_cast<uint8_t>(_pending >> 8);
+        out[2] = static_cast<uint8_t>(_pending >> 16);
+
+        _used += 3;
+        _pending = 0;
+        _pendingCount = 0;
+
+        if (_used == _bufferBytes)
+            submit();
+    }
+
+    // Hands the active buffer to the I/O thread and continues on the other one,
+    // waiting only if that one is still being written.
+    void submit(){
+        {
+            std::unique_lock lock(_mutex);
+            _cv.wait(lock, [this]{ return !_busy; });
+
+            _queued = _active;
+            _queuedBytes = _used;
+            _busy = true;
+        }
+        _cv.notify_all();
+
+        _active ^= 1;
+        _used = 0;
+    }
+
+    void ioLoop(){
+        std::unique_lock lock(_mutex);
+
+        while (true){
+            _cv.wait(lock, [this]{ return _busy || _stop; });
+            if (!_busy) return;
+
+            auto* data = _buffers[_queued];
+            size_t size = _queuedBytes;
+            lock.unlock();
+
+            writeBlock(data, size);
+
+            lock.lock();
+            _busy = false;
+            _cv.notify_all();
+        }
+    }
+
+    void writeBlock(const uint8_t* data, size_t size){
+        if (_error != 0) return;
+
+#ifdef O_DIRECT
+        // only the tail can be shorter than a page, O_DIRECT would reject it
+        if (size % moveLogDataOffset != 0)
+            fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL) & ~O_DIRECT);
+#endif
+
+        while (size > 0){
+            auto written = pwrite(_fd, data, size, static_cast<off_t>(_fileOffset));
+            if (written < 0){
+                if (errno == EINTR) continue;
+                _error = errno;
+                return;
+            }
+
+            data += written;
+            size -= written;
+            _fileOffset += written;
+        }
+    }
+
+    void release(){
+        for (auto& buffer : _buffers){
+            std::free(buffer);
+            buffer = nullptr;
+        }
+
+        if (_fd >= 0) close(_fd);
+        _fd = -1;
+    }
+
+    size_t _towerLevels;
+    size_t _bufferBytes;
+    int _fd = -1;
+
+    uint8_t* _buffers[2] = {};
+    int _active = 0;
+    size_t _used = 0;
+    uint32_t _pending = 0;
+    uint32_t _pendingCount = 0;
+    uint64_t _moves = 0;
+    bool _finished = false;
+
+    std::thread _ioThread;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    int _queued = 0;
+    size_t _queuedBytes = 0;
+    bool _busy = false;
+    bool _stop = false;
+    size_t _fileOffset = moveLogDataOffset;
+    int _error = 0;
+};
+
+// Maps a move log read-only and decodes it, either move by move or as a replay against a hanoi.
+class moveLogReader{
+public:
+    explicit moveLogReader(const std::string& path){
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) [[unlikely]]
+            throw std::runtime_error("[ ERROR ] Cannot open " + path + ": " + std::strerror(errno) + "\n");
+
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < moveLogDataOffset){
+            close(fd);
+            throw std::runtime_error("[ ERROR ] " + path + " is not a move log\n");
+        }
+
+        _size = st.st_size;
+        void* map = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (map == MAP_FAILED) [[unlikely]]
+            throw std::runtime_error("[ ERROR ] Cannot map " + path + ": " + std::strerror(errno) + "\n");
+
+        _map = static_cast<const uint8_t*>(map);
+        madvise(map, _size, MADV_SEQUENTIAL);
+        std::memcpy(&_header, _map, sizeof(_header));
+
+        uint64_t packedBytes = _header.moves / 8 * 3 + (_header.moves % 8 ? 3 : 0);
+        if (std::memcmp(_header.magic, moveLogMagic, sizeof(moveLogMagic)) != 0 || _header.version != moveLogVersion ||
+            _size - moveLogDataOffset < packedBytes){
+            munmap(map, _size);
+            throw std::runtime_error("[ ERROR ] " + path + " is not a valid move log\n");
+        }
+    }
+
+    ~moveLogReader(){
+        munmap(const_cast<uint8_t*>(_map), _size);
+    }
+
+    moveLogReader(const moveLogReader&) = delete;
+    moveLogReader& operator=(const moveLogReader&) = delete;
+
+    [[nodiscard]] size_t towerLevels() const { return _header.towerLevels; }
+    [[nodiscard]] uint64_t moves() const { return _header.moves; }
+
+    // Move i (0-based) without decoding the ones before it.
+    [[nodiscard]] hanoiMove operator[](uint64_t i) const{
+        const uint8_t* group = _map + moveLogDataOffset + i / 8 * 3;
+        uint32_t bits = group[0] | group[1] << 8 | group[2] << 16;
+
+        return decodeLogMove(bits >> (3 * (i % 8)) & 7);
+    }
+
+    template<class F>
+    void forEach(F&& f) const{
+        const uint8_t* group = _map + moveLogDataOffset;
+        uint64_t left = _header.moves;
+
+        for (; left > 0; group += 3){
+            uint32_t bits = group[0] | group[1] << 8 | group[2] << 16;
+
+            for (int j = 0; j < 8 && left > 0; ++j, --left, bits >>= 3)
+                f(decodeLogMove(bits & 7));
+        }
+    }
+
+    // Plays the whole log on the game, false on the first illegal move or if the tower ends unsolved.
+    template<template<size_t> class towersT>
+    bool replay(hanoi<3, towersT>& game) const{
+        bool valid = true;
+        forEach([&](hanoiMove move){
+            valid = valid && game.playMove(move.src, move.dst);
+        });
+
+        return valid && game.isSolved();
+    }
+
+private:
+    const uint8_t* _map = nullptr;
+    size_t _size = 0;
+    moveLogHeader _header{};
+};
+
+// Streams the optimal solution straight from the closed-form generator into a move log.
+inline uint64_t recordSolution(const std::string& path, size_t towerLevels, bool direct = false){
+    moveLogWriter writer(path, towerLevels, direct);
+    for (auto move : hanoiMoves(towerLevels))
+        writer.append(move);
+
+    writer.finish();
+    return writer.moves();
+}
+
+#endif //HANOI_MOVELOG_H
@@ -0,0 +1,112 @@
+#ifndef HANOI_MOVES_H
+#define HANOI_MOVES_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+struct hanoiMove{
+    uint8_t src;
+    uint8_t dst;
+
+    friend constexpr bool operator==(const hanoiMove&, const hanoiMove&) = default;
+};
+
+constexpr uint64_t moveCount(size_t towerLevels){
+    return towerLevels >= 64 ? UINT64_MAX : (uint64_t{ 1 } << towerLevels) - 1;
+}
+
+// Move k (1-based) of the optimal solution, read straight from the bits of k.
+// The raw formula carries the tower to peg 1 for even heights, so those get pegs 1 and 2 mirrored.
+constexpr hanoiMove moveAt(uint64_t k, size_t towerLevels){
+    constexpr uint8_t label[2][3] = { { 0, 1, 2 }, { 0, 2, 1 } };
+    const uint8_t* peg = label[towerLevels % 2 == 0];
+
+    return { peg[(k & (k - 1)) % 3], peg[((k | (k - 1)) % 3 + 1) % 3] };
+}
+
+// Peg of disc d (1 = smallest) after the first k moves of the optimal solution.
+// Disc d has moved (k + 2^(d-1)) / 2^d times and cycles through the pegs in a fixed direction,
+// forward (0 -> 1 -> 2) when n - d is odd and backward otherwise.
+constexpr uint8_t discPegAfter(size_t towerLevels, size_t disc, uint64_t k){
+    uint64_t moved = (disc < 64 ? k >> disc : 0) + (k >> (disc - 1) & 1);
+    uint64_t step = (towerLevels - disc) % 2 ? 1 : 2;
+
+    return static_cast<uint8_t>((moved % 3) * step % 3);
+}
+
+// Lazy range over the moves of a full solution, nothing is stored besides the move index and the peg of every disc.
+class hanoiMoves{
+public:
+    class iterator{
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = hanoiMove;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = hanoiMove;
+
+        constexpr iterator() = default;
+
+        // Starts with every disc where the solution leaves it after moveIdx moves.
+        constexpr iterator(uint64_t moveIdx, size_t towerLevels): _moveIdx{ moveIdx }{
+            for (size_t d = 1; d <= towerLevels && d <= 64; ++d){
+                _discPeg[d - 1] = discPegAfter(towerLevels, d, moveIdx);
+                if ((towerLevels - d) % 2) _forward |= uint64_t{ 1 } << (d - 1);
+            }
+        }
+
+        // Only good for comparing against, e.g. the end of a range.
+        constexpr explicit iterator(uint64_t moveIdx): _moveIdx{ moveIdx } {}
+
+        // Move k + 1 is made by disc countr_zero(k + 1) + 1, one step in the direction that disc always takes.
+        constexpr hanoiMove operator*() const{
+            auto disc = std::countr_zero(_moveIdx + 1);
+            uint8_t src = _discPeg[disc];
+
+            return { src, nextPeg[_forward >> disc & 1][src] };
+        }
+
+        constexpr iterator& operator++(){
+            auto disc = std::countr_zero(_moveIdx + 1);
+            _discPeg[disc] = nextPeg[_forward >> disc & 1][_discPeg[disc]];
+            ++_moveIdx;
+            return *this;
+        }
+
+        constexpr iterator operator++(int){
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        constexpr bool operator==(const iterator& other) const { return _moveIdx == other._moveIdx; }
+
+    private:
+        // backward (0 -> 2 -> 1) and forward (0 -> 1 -> 2)
+        static constexpr uint8_t nextPeg[2][3] = { { 2, 0, 1 }, { 1, 2, 0 } };
+
+        uint64_t _moveIdx = 0;
+        uint64_t _forward = 0; // bit d - 1 is set when disc d cycles forward
+        uint8_t _discPeg[64] = {};
+    };
+
+    constexpr explicit hanoiMoves(size_t towerLevels)
+        : _towerLevels{ towerLevels }, _first{ 0 }, _last{ moveCount(towerLevels) } {}
+
+    // Only the moves with 0-based index in [first, last), e.g. one chunk of a split solution.
+    constexpr hanoiMoves(size_t towerLevels, uint64_t first, uint64_t last)
+        : _towerLevels{ towerLevels }, _first{ first }, _last{ last } {}
+
+    [[nodiscard]] constexpr iterator begin() const { return { _first, _towerLevels }; }
+    [[nodiscard]] constexpr iterator end() const { return iterator{ _last }; }
+    [[nodiscard]] constexpr uint64_t size() const { return _last - _first; }
+
+private:
+    size_t _towerLevels;
+    uint64_t _first;
+    uint64_t _last;
+};
+
+#endif //HANOI_MOVES_H
@@ -0,0 +1,73 @@
+#ifndef HANOI_PARALLEL_H
+#define HANOI_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "bitboard.h"
+#include "moves.h"
+
+struct parallelReport{
+    bool valid;
+    size_t chunks;
+    uint64_t moves;
+    bitboardTowers<> finalTowers;
+};
+
+// Splits the move range [0, 2^n - 1) into chunks and plays them on all threads at once.
+// Each chunk starts from the closed-form state at its first move, validates every move it makes,
+// and its end state must match the closed-form state at the next chunk's start.
+inline parallelReport playGameParallel(size_t towerLevels, unsigned threads = 0, uint64_t chunkMoves = uint64_t{ 1 } << 24){
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    const uint64_t total = moveCount(towerLevels);
+    const size_t chunks = std::max<uint64_t>(1, total / chunkMoves + (total % chunkMoves != 0));
+
+    std::vector<bitboardTowers<>> endStates(chunks, bitboardTowers<>(towerLevels));
+    std::vector<char> chunkValid(chunks, false);
+    std::atomic<size_t> nextChunk{ 0 };
+
+    auto worker = [&]() -> void
+    {
+        for (size_t chunk; (chunk = nextChunk.fetch_add(1, std::memory_order_relaxed)) < chunks; ){
+            uint64_t first = chunk * chunkMoves;
+            uint64_t last = first + std::min(chunkMoves, total - first);
+
+            auto towers = bitboardTowers<>::afterMoves(towerLevels, first);
+            bool valid = true;
+
+            for (auto [src, dst] : hanoiMoves(towerLevels, first, last)){
+                valid &= towers.canMove(src, dst);
+                towers.move(src, dst);
+            }
+
+            endStates[chunk] = towers;
+            chunkValid[chunk] = valid;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < std::min<uint64_t>(threads, chunks); ++i)
+        pool.emplace_back(worker);
+    worker();
+
+    for (auto& t : pool)
+        t.join();
+
+    bool valid = std::all_of(chunkValid.begin(), chunkValid.end(), [](char v){ return v; });
+    for (size_t chunk = 0; valid && chunk < chunks; ++chunk){
+        uint64_t first = chunk * chunkMoves;
+        uint64_t boundary = first + std::min(chunkMoves, total - first);
+        valid = endStates[chunk] == bitboardTowers<>::afterMoves(towerLevels, boundary);
+    }
+
+    auto& finalTowers = endStates.back();
+    valid = valid && finalTowers.height(0) == 0 && finalTowers.height(1) == 0;
+
+    return { valid, chunks, total, finalTowers };
+}
+
+#endif //HANOI_PARALLEL_H
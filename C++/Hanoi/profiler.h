@@ -0,0 +1,239 @@
+#ifndef HANOI_PROFILER_H
+#define HANOI_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware counters read by the profiler, cycles first since it leads the perf group.
+enum class perfCounter{ cycles, instructions, branchMisses, l1dMisses, llcMisses, count };
+
+struct counterValues{
+    uint64_t values[static_cast<size_t>(perfCounter::count)] = {};
+    uint32_t availableMask = 0;
+
+    [[nodiscard]] bool available(perfCounter counter) const { return availableMask >> static_cast<size_t>(counter) & 1; }
+};
+
+// One perf_event group per thread, opened on first use and left running. Scopes only read it,
+// so entering and leaving a scope costs one read() each. Counters the kernel refuses
+// (no PMU, perf_event_paranoid, containers) are simply reported as unavailable.
+class perfGroup{
+public:
+    perfGroup(){
+#ifdef __linux__
+        static const std::pair<uint32_t, uint64_t> events[] = {
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+            { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16 },
+            { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16 },
+        };
+
+        for (size_t i = 0; i < std::size(events); ++i){
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = events[i].first;
+            attr.config = events[i].second;
+            attr.disabled = _leader < 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, _leader, 0));
+            if (fd < 0) continue;
+
+            if (_leader < 0) _leader = fd;
+            _fds.push_back(fd);
+            _slots.push_back(i);
+        }
+
+        if (_leader >= 0){
+            ioctl(_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    ~perfGroup(){
+#ifdef __linux__
+        for (int fd : _fds) close(fd);
+#endif
+    }
+
+    perfGroup(const perfGroup&) = delete;
+    perfGroup& operator=(const perfGroup&) = delete;
+
+    // Current counter values, scaled up if the kernel had to multiplex the group.
+    [[nodiscard]] counterValues read() const{
+        counterValues ret;
+#ifdef __linux__
+        if (_leader < 0) return ret;
+
+        uint64_t buffer[3 + static_cast<size_t>(perfCounter::count)] = {};
+        if (::read(_leader, buffer, sizeof(buffer)) <= 0) return ret;
+
+        double scale = buffer[2] > 0 ? (double)buffer[1] / (double)buffer[2] : 1.0;
+        for (size_t i = 0; i < buffer[0] && i < _slots.size(); ++i){
+            ret.values[_slots[i]] = static_cast<uint64_t>((double)buffer[3 + i] * scale);
+            ret.availableMask |= 1u << _slots[i];
+        }
+#endif
+        return ret;
+    }
+
+    static perfGroup& forThisThread(){
+        thread_local perfGroup group;
+        return group;
+    }
+
+private:
+    int _leader = -1;
+    std::vector<int> _fds;
+    std::vector<size_t> _slots;
+};
+
+// Collects the finished scopes of all threads and prints them as one table at exit (or on demand).
+class profiler{
+public:
+    struct entry{
+        uint64_t calls = 0;
+        double wallSec = 0;
+        counterValues counters;
+    };
+
+    static profiler& instance(){
+        static profiler registry;
+        return registry;
+    }
+
+    ~profiler(){
+        if (!_entries.empty()) printSummary();
+    }
+
+    void record(const std::string& path, double wallSec, const counterValues& delta){
+        std::lock_guard lock(_mutex);
+        auto& e = _entries[path];
+
+        ++e.calls;
+        e.wallSec += wallSec;
+        e.counters.availableMask |= delta.availableMask;
+        for (size_t i = 0; i < static_cast<size_t>(perfCounter::count); ++i)
+            e.counters.values[i] += delta.values[i];
+    }
+
+    void printSummary(){
+        std::lock_guard lock(_mutex);
+
+        uint32_t availableMask = 0;
+        for (const auto& [path, e] : _entries)
+            availableMask |= e.counters.availableMask;
+
+        if (availableMask == 0)
+            std::printf("Hardware counters unavailable, showing wall time only\n");
+
+        std::printf("%-40s %6s %12s %14s %14s %6s %12s %12s %12s\n",
+                    "scope", "calls", "wall [s]", "cycles", "instructions", "IPC", "br-misses", "L1d-misses", "LLC-misses");
+
+        auto column = [&](const counterValues& counters, perfCounter counter, int width){
+            auto value = counters.values[static_cast<size_t>(counter)];
+            if (counters.available(counter)) std::printf(" %*llu", width, (unsigned long long)value);
+            else std::printf(" %*s", width, "-");
+        };
+
+        for (const auto& [path, e] : _entries){
+            const auto& c = e.counters;
+            std::printf("%-40s %6llu %12.6f", path.c_str(), (unsigned long long)e.calls, e.wallSec);
+
+            column(c, perfCounter::cycles, 14);
+            column(c, perfCounter::instructions, 14);
+
+            if (c.available(perfCounter::cycles) && c.available(perfCounter::instructions) && c.values[0] > 0)
+                std::printf(" %6.2f", (double)c.values[1] / (double)c.values[0]);
+            else std::printf(" %6s", "-");
+
+            column(c, perfCounter::branchMisses, 12);
+            column(c, perfCounter::l1dMisses, 12);
+            column(c, perfCounter::llcMisses, 12);
+            std::printf("\n");
+        }
+
+        _entries.clear();
+    }
+
+private:
+    profiler() = default;
+
+    std::mutex _mutex;
+    std::map<std::string, entry> _entries;
+};
+
+// RAII scope measuring wall time and hardware counters from construction to destruction (or Stop()).
+// Nested scopes on the same thread are reported under "outer/inner".
+class profileScope{
+public:
+    explicit profileScope(const std::string& name): _path{ nestedPath(name) }{
+        _counters = perfGroup::forThisThread().read();
+        _start = std::chrono::steady_clock::now();
+    }
+
+    ~profileScope()
+    {
+        if (!_wasStopped) Stop();
+    }
+
+    profileScope(const profileScope&) = delete;
+    profileScope& operator=(const profileScope&) = delete;
+
+    void Stop()
+    {
+        auto stop = std::chrono::steady_clock::now();
+        auto counters = perfGroup::forThisThread().read();
+
+        counters.availableMask &= _counters.availableMask;
+        for (size_t i = 0; i < static_cast<size_t>(perfCounter::count); ++i)
+            counters.values[i] -= _counters.values[i];
+
+        profiler::instance().record(_path, std::chrono::duration<double>(stop - _start).count(), counters);
+
+        currentPath().resize(_parentPathSize);
+        _wasStopped = true;
+    }
+
+private:
+    static std::string& currentPath(){
+        thread_local std::string path;
+        return path;
+    }
+
+    std::string nestedPath(const std::string& name){
+        auto& path = currentPath();
+        _parentPathSize = path.size();
+
+        if (!path.empty()) path += '/';
+        path += name;
+
+        return path;
+    }
+
+    size_t _parentPathSize = 0;
+    std::string _path;
+    bool _wasStopped = false;
+    counterValues _counters;
+    std::chrono::time_point<std::chrono::steady_clock> _start;
+};
+
+#endif //HANOI_PROFILER_H
@@ -0,0 +1,185 @@
+#ifndef HANOI_RENDERER_H
+#define HANOI_RENDERER_H
+
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Formats whole frames of towers into one preallocated buffer and hands each frame to a single write().
+// Frames can be throttled to a maximum rate (skipped frames are dropped, the final one is always shown)
+// or recorded to a file and replayed later with playbackFrames.
+class frameRenderer{
+public:
+    frameRenderer() = default;
+
+    ~frameRenderer(){
+        if (_fd != STDOUT_FILENO) close(_fd);
+    }
+
+    frameRenderer(const frameRenderer&) = delete;
+    frameRenderer& operator=(const frameRenderer&) = delete;
+
+    // 0 shows every frame.
+    void setMaxFps(double maxFps){
+        _minFrameGap = maxFps > 0 ? std::chrono::nanoseconds(static_cast<int64_t>(1e9 / maxFps)) : std::chrono::nanoseconds(0);
+    }
+
+    // Frames go to the file instead of the terminal, prefixed by a header so they can be played back.
+    void recordTo(const std::string& path){
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) [[unlikely]]
+            throw std::runtime_error("[ ERROR ] Cannot open " + path + ": " + std::strerror(errno) + "\n");
+
+        if (_fd != STDOUT_FILENO) close(_fd);
+        _fd = fd;
+        _headerWritten = false;
+    }
+
+    // Whether the next frame should be drawn, remembers it otherwise so finish() can still show it.
+    bool frameDue(){
+        if (_minFrameGap.count() == 0)
+            return true;
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - _lastFrame < _minFrameGap){
+            _skipped = true;
+            return false;
+        }
+
+        _lastFrame = now;
+        return true;
+    }
+
+    [[nodiscard]] bool hasSkippedFrame() const { return _skipped; }
+
+    // columns holds towerLevels slots per tower, bottom to top, heights says how many are used.
+    template<class dtype>
+    void draw(const dtype* columns, const size_t* heights, size_t towersCount, size_t towerLevels){
+        const size_t cellWidth = digits(towerLevels);
+        const size_t rowSize = 2 + towersCount * (cellWidth + 5) + 1;
+        const size_t footerSize = towersCount * (cellWidth + 5);
+        const size_t frameSize = towerLevels * rowSize + footerSize;
+
+        if (_frame.size() != frameSize)
+            _frame.assign(frameSize, ' ');
+
+        char* out = _frame.data();
+        for (size_t i = towerLevels; i > 0; --i){
+            out += 2;
+
+            for (size_t j = 0; j < towersCount; ++j){
+                char* cell = out;
+                std::memset(cell, ' ', cellWidth + 5);
+
+                if (heights[j] >= i)
+                    std::to_chars(cell, cell + cellWidth, columns[j * towerLevels + i - 1]);
+                else
+                    *cell = '|';
+
+                out += cellWidth + 5;
+            }
+
+            *out++ = '\n';
+        }
+
+        for (size_t j = 0; j < towersCount; ++j){
+            std::memset(out, '_', cellWidth + 4);
+            out += cellWidth + 4;
+            *out++ = j + 1 < towersCount ? ' ' : '\n';
+        }
+
+        if (!_headerWritten && _fd != STDOUT_FILENO){
+            std::string header = std::string(recordingMagic) + ' ' + std::to_string(frameSize) + '\n';
+            writeAll(header.data(), header.size());
+            _headerWritten = true;
+        }
+
+        if (_fd == STDOUT_FILENO)
+            std::cout.flush();
+
+        writeAll(_frame.data(), _frame.size());
+        _skipped = false;
+    }
+
+    static constexpr const char* recordingMagic = "HANOI-FRAMES";
+
+private:
+    static size_t digits(size_t x){
+        size_t ret = 1;
+        for (; x >= 10; x /= 10) ++ret;
+
+        return ret;
+    }
+
+    void writeAll(const char* data, size_t size){
+        while (size > 0){
+            auto written = write(_fd, data, size);
+            if (written < 0){
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("[ ERROR ] Frame write failed: ") + std::strerror(errno) + "\n");
+            }
+
+            data += written;
+            size -= written;
+        }
+    }
+
+    std::vector<char> _frame;
+    int _fd = STDOUT_FILENO;
+    bool _headerWritten = false;
+    bool _skipped = false;
+    std::chrono::nanoseconds _minFrameGap{ 0 };
+    std::chrono::steady_clock::time_point _lastFrame{};
+};
+
+// Writes the frames of a recording made with frameRenderer::recordTo to stdout at the given rate.
+inline void playbackFrames(const std::string& path, double fps){
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) [[unlikely]]
+        throw std::runtime_error("[ ERROR ] Cannot open " + path + ": " + std::strerror(errno) + "\n");
+
+    std::string header;
+    for (char c; read(fd, &c, 1) == 1 && c != '\n'; )
+        header += c;
+
+    size_t frameSize = 0;
+    const auto magicLen = std::strlen(frameRenderer::recordingMagic);
+    if (header.compare(0, magicLen, frameRenderer::recordingMagic) != 0 ||
+        std::from_chars(header.data() + magicLen + 1, header.data() + header.size(), frameSize).ec != std::errc{} ||
+        frameSize == 0){
+        close(fd);
+        throw std::runtime_error("[ ERROR ] " + path + " is not a frame recording\n");
+    }
+
+    std::vector<char> frame(frameSize);
+    const auto frameGap = std::chrono::nanoseconds(fps > 0 ? static_cast<int64_t>(1e9 / fps) : 0);
+    auto nextFrame = std::chrono::steady_clock::now();
+
+    while (true){
+        size_t got = 0;
+        for (ssize_t r; got < frameSize && (r = read(fd, frame.data() + got, frameSize - got)) > 0; )
+            got += r;
+        if (got < frameSize) break;
+
+        std::this_thread::sleep_until(nextFrame);
+        nextFrame += frameGap;
+
+        for (size_t done = 0; done < frameSize; ){
+            auto written = write(STDOUT_FILENO, frame.data() + done, frameSize - done);
+            if (written < 0 && errno != EINTR) break;
+            if (written > 0) done += written;
+        }
+    }
+
+    close(fd);
+}
+
+#endif //HANOI_RENDERER_H
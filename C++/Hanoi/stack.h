@@ -1,43 +1,123 @@
 #ifndef HANOI_STACK_H
 #define HANOI_STACK_H
 
+#include <array>
 #include <cstdio>
 #include <exception>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <tuple>
+#include <utility>
+
+// Checking policies, they decide what misuse of a stack costs.
+struct checkedAccess{
+    static void onPush(bool isFull){
+        if (isFull) [[unlikely]]
+            throw std::out_of_range("[ ERROR ] Stack overflowed\n");
+    }
+
+    static void onTop(bool isEmpty){
+        if (isEmpty) [[unlikely]]
+            throw std::out_of_range("[ ERROR ] Stack is empty\n");
+    }
+
+    // popping an empty stack is a no-op
+    static bool onPop(bool isEmpty) { return !isEmpty; }
+};
+
+struct uncheckedAccess{
+    static void onPush(bool) {}
+    static void onTop(bool) {}
+    static bool onPop(bool) { return true; }
+};
+
+#ifdef NDEBUG
+using defaultAccess = uncheckedAccess;
+#else
+using defaultAccess = checkedAccess;
+#endif
+
+constexpr size_t dynamicCapacity = 0;
+
+// Storage is inline when the capacity is known at compile time and on the heap otherwise.
+template<class numT, size_t capacity>
+class stackStorage{
+public:
+    stackStorage() = default;
+    explicit stackStorage(size_t maxSize){
+        if (maxSize > capacity) [[unlikely]]
+            throw std::out_of_range("[ ERROR ] Stack capacity exceeded\n");
+    }
+
+    numT* data() { return _arr.data(); }
+    const numT* data() const { return _arr.data(); }
+    [[nodiscard]] size_t size() const { return capacity; }
+
+private:
+    std::array<numT, capacity> _arr{};
+};
 
 template<class numT>
+class stackStorage<numT, dynamicCapacity>{
+public:
+    stackStorage() = default;
+    explicit stackStorage(size_t maxSize): _arr{ new numT[maxSize] }, _arrSize{ maxSize } {}
+
+    stackStorage(stackStorage&& other) noexcept
+        : _arr{ std::move(other._arr) }, _arrSize{ std::exchange(other._arrSize, 0) } {}
+
+    stackStorage& operator=(stackStorage&& other) noexcept{
+        _arr = std::move(other._arr);
+        _arrSize = std::exchange(other._arrSize, 0);
+        return *this;
+    }
+
+    numT* data() { return _arr.get(); }
+    const numT* data() const { return _arr.get(); }
+    [[nodiscard]] size_t size() const { return _arrSize; }
+
+private:
+    std::unique_ptr<numT[]> _arr;
+    size_t _arrSize = 0;
+};
+
+template<class numT, size_t capacity = dynamicCapacity, class checkPolicy = defaultAccess>
 class stack{
 public:
-    stack(): _arr{ nullptr }, _arrSize{ 0 }, _used{ 0 } {}
-    explicit stack(size_t maxSize): _arr { new numT[maxSize] }, _arrSize{ maxSize }, _used{ 0 } {}
-    ~stack() { delete[] _arr; }
+    stack() = default;
+    explicit stack(size_t maxSize): _storage{ maxSize } {}
+
+    stack(stack&& other) noexcept: _storage{ std::move(other._storage) }, _used{ std::exchange(other._used, 0) } {}
+
+    stack& operator=(stack&& other) noexcept{
+        _storage = std::move(other._storage);
+        _used = std::exchange(other._used, 0);
+        return *this;
+    }
 
     void push(numT x){
-        if (isFull()) [[unlikely]]
-            throw std::out_of_range("[ ERROR ] Stack overflowed\n");
+        checkPolicy::onPush(isFull());
 
-        _arr[_used++] = x;
+        _storage.data()[_used++] = x;
     }
 
     void pop(){
-        if (isEmpty())[[unlikely]] return;
-
-        --_used;
+        if (checkPolicy::onPop(isEmpty()))
+            --_used;
     }
 
-    numT top(){
-        if (isEmpty())[[unlikely]]
-            throw std::out_of_range("[ ERROR ] Stack is empty\n");
+    numT top() const{
+        checkPolicy::onTop(isEmpty());
 
-        return _arr[_used - 1];
+        return _storage.data()[_used - 1];
     }
 
+    // Checks emptiness once for both the read and the pop.
     numT topNPop(){
-        auto ret = top();
-        pop();
+        checkPolicy::onTop(isEmpty());
 
-        return ret;
+        return _storage.data()[--_used];
     }
 
     [[nodiscard]] bool isEmpty() const{
@@ -45,17 +125,16 @@ public:
     }
 
     [[nodiscard]] bool isFull() const {
-        return  _used == _arrSize;
+        return  _used == _storage.size();
     }
 
-    std::tuple<const numT*, size_t> getUnderlyingData(){
-        return std::tuple(_arr, _used);
+    std::tuple<const numT*, size_t> getUnderlyingData() const{
+        return std::tuple(_storage.data(), _used);
     }
 
 private:
-    numT* _arr;
-    size_t _arrSize;
-    size_t _used;
+    stackStorage<numT, capacity> _storage;
+    size_t _used = 0;
 };
 
 #endif //HANOI_STACK_H
@@ -0,0 +1,57 @@
+#ifndef HANOI_STATE_H
+#define HANOI_STATE_H
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "moves.h"
+
+// Peg of every disc, pegs[d - 1] holds disc d (1 = smallest).
+using towerConfig = std::vector<uint8_t>;
+
+// Rejects a layout that puts a disc on a peg the towers do not have.
+inline void validatePegs(const towerConfig& pegs, size_t pegCount){
+    for (auto peg : pegs)
+        if (peg >= pegCount) [[unlikely]]
+            throw std::invalid_argument("[ ERROR ] Layout uses a peg the towers do not have\n");
+}
+
+// Layout after the first k moves of the optimal 0 -> 2 solution, O(n) and without replaying anything.
+inline towerConfig stateAfterMove(size_t towerLevels, uint64_t k){
+    towerConfig pegs(towerLevels);
+    for (size_t d = 1; d <= towerLevels; ++d)
+        pegs[d - 1] = discPegAfter(towerLevels, d, k);
+
+    return pegs;
+}
+
+// Inverse of stateAfterMove: how many moves of the optimal solution lead to the given layout,
+// or nothing when the layout never shows up on that path.
+// Walks from the largest disc down: it either still sits on the current source (its subtower is
+// heading for the spare peg) or already lies on the current destination (2^(d-1) moves are behind us).
+inline std::optional<uint64_t> moveIndexOf(const towerConfig& pegs){
+    if (pegs.size() > 64) [[unlikely]]
+        return std::nullopt;
+
+    uint64_t k = 0;
+    uint8_t srcTower = 0;
+    uint8_t tmpTower = 1;
+    uint8_t dstTower = 2;
+
+    for (size_t d = pegs.size(); d > 0; --d){
+        if (pegs[d - 1] == srcTower){
+            std::swap(tmpTower, dstTower);
+        }
+        else if (pegs[d - 1] == dstTower){
+            k += uint64_t{ 1 } << (d - 1);
+            std::swap(srcTower, tmpTower);
+        }
+        else return std::nullopt;
+    }
+
+    return k;
+}
+
+#endif //HANOI_STATE_H
@@ -0,0 +1,205 @@
+#ifndef HANOI_STATESEARCH_H
+#define HANOI_STATESEARCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "state.h"
+#include "threadPool.h"
+
+// Breadth-first search over every layout of a 3-peg puzzle, for rule variants without a closed form.
+// A layout is the base-3 number whose digit i is the peg of disc i + 1, so n discs span 3^n states,
+// and visited states are one bit each. Every BFS level is expanded by all pool threads at once.
+//
+// Rules are a predicate on a single move, rule(disc, src, dst, dstTop), where dstTop is the top disc
+// of dst (0 for an empty peg). Discs never land on smaller ones, whatever the rule says.
+
+struct classicRules{
+    bool operator()(uint32_t, uint8_t, uint8_t, uint32_t) const { return true; }
+};
+
+// Discs only travel clockwise, 0 -> 1 -> 2 -> 0.
+struct cyclicRules{
+    bool operator()(uint32_t, uint8_t src, uint8_t dst, uint32_t) const { return dst == (src + 1) % 3; }
+};
+
+// No jumps between the outer pegs.
+struct adjacentRules{
+    bool operator()(uint32_t, uint8_t src, uint8_t dst, uint32_t) const { return src + dst != 2; }
+};
+
+inline uint64_t encodeState(const towerConfig& pegs){
+    uint64_t code = 0;
+    for (size_t d = pegs.size(); d > 0; --d)
+        code = code * 3 + pegs[d - 1];
+
+    return code;
+}
+
+inline towerConfig decodeState(uint64_t code, size_t towerLevels){
+    towerConfig pegs(towerLevels);
+    for (auto& peg : pegs){
+        peg = static_cast<uint8_t>(code % 3);
+        code /= 3;
+    }
+
+    return pegs;
+}
+
+template<class ruleT = classicRules>
+class stateSearch{
+public:
+    static constexpr size_t maxLevels = 20;
+
+    stateSearch(size_t towerLevels, threadPool& pool, ruleT rule = {})
+        : _towerLevels{ towerLevels }, _pool{ pool }, _rule{ rule }
+    {
+        if (towerLevels == 0 || towerLevels > maxLevels) [[unlikely]]
+            throw std::out_of_range("[ ERROR ] State search supports 1 to 20 discs\n");
+
+        _pow3[0] = 1;
+        for (size_t i = 1; i <= towerLevels; ++i)
+            _pow3[i] = _pow3[i - 1] * 3;
+    }
+
+    [[nodiscard]] uint64_t stateCount() const { return _pow3[_towerLevels]; }
+
+    // Level-synchronous BFS from start. onLevel(depth, frontier) sees every level and may return false
+    // to stop early. Returns the depth of the last level visited.
+    template<class F>
+    size_t run(uint64_t start, F&& onLevel){
+        const uint64_t words = (stateCount() + 63) / 64;
+        _visited = std::make_unique<std::atomic<uint64_t>[]>(words);
+        for (uint64_t i = 0; i < words; ++i)
+            _visited[i].store(0, std::memory_order_relaxed);
+
+        std::vector<uint64_t> frontier{ start };
+        claim(start);
+
+        size_t depth = 0;
+        while (true){
+            if (!onLevel(depth, frontier))
+                return depth;
+
+            auto next = expand(frontier);
+            if (next.empty())
+                return depth;
+
+            frontier = std::move(next);
+            ++depth;
+        }
+    }
+
+    // Fewest moves between two layouts under the rules, nothing if goal cannot be reached.
+    std::optional<uint64_t> distance(const towerConfig& start, const towerConfig& goal){
+        checkSize(start);
+        checkSize(goal);
+
+        const uint64_t target = encodeState(goal);
+        std::optional<uint64_t> ret;
+
+        run(encodeState(start), [&](size_t depth, const std::vector<uint64_t>&){
+            if (isVisited(target)) ret = depth;
+            return !ret;
+        });
+
+        return ret;
+    }
+
+    // Distance of every layout from start (indexed by encodeState), unreachable ones get UINT32_MAX.
+    // Needs 4 bytes per state, so about 14 GB at 20 discs.
+    std::vector<uint32_t> distanceTable(const towerConfig& start){
+        checkSize(start);
+
+        std::vector<uint32_t> table(stateCount(), std::numeric_limits<uint32_t>::max());
+        run(encodeState(start), [&](size_t depth, const std::vector<uint64_t>& frontier){
+            _pool.parallelFor(frontier.size(), [&](size_t i){ table[frontier[i]] = static_cast<uint32_t>(depth); }, 4096);
+            return true;
+        });
+
+        return table;
+    }
+
+private:
+    static constexpr size_t expandGrain = 4096;
+
+    void checkSize(const towerConfig& pegs) const{
+        if (pegs.size() != _towerLevels) [[unlikely]]
+            throw std::invalid_argument("[ ERROR ] Layout does not match the number of discs\n");
+    }
+
+    [[nodiscard]] bool isVisited(uint64_t state) const{
+        return _visited[state / 64].load(std::memory_order_relaxed) >> (state % 64) & 1;
+    }
+
+    // True only for the one thread that marks the state first.
+    bool claim(uint64_t state){
+        uint64_t bit = uint64_t{ 1 } << (state % 64);
+        return !(_visited[state / 64].fetch_or(bit, std::memory_order_relaxed) & bit);
+    }
+
+    std::vector<uint64_t> expand(const std::vector<uint64_t>& frontier){
+        const size_t chunks = (frontier.size() + expandGrain - 1) / expandGrain;
+        std::vector<std::vector<uint64_t>> found(chunks);
+
+        _pool.parallelFor(chunks, [&](size_t chunk){
+            size_t last = std::min(frontier.size(), (chunk + 1) * expandGrain);
+            for (size_t i = chunk * expandGrain; i < last; ++i)
+                successors(frontier[i], found[chunk]);
+        }, 1);
+
+        size_t total = 0;
+        for (const auto& part : found)
+            total += part.size();
+
+        std::vector<uint64_t> next;
+        next.reserve(total);
+        for (const auto& part : found)
+            next.insert(next.end(), part.begin(), part.end());
+
+        return next;
+    }
+
+    void successors(uint64_t state, std::vector<uint64_t>& out){
+        // top disc of every peg, 0 while the peg is empty
+        uint32_t top[3] = { 0, 0, 0 };
+        int missing = 3;
+
+        uint64_t rest = state;
+        for (uint32_t disc = 1; disc <= _towerLevels && missing > 0; ++disc, rest /= 3){
+            auto peg = rest % 3;
+            if (top[peg] == 0){
+                top[peg] = disc;
+                --missing;
+            }
+        }
+
+        for (uint8_t src = 0; src < 3; ++src){
+            uint32_t disc = top[src];
+            if (disc == 0) continue;
+
+            for (uint8_t dst = 0; dst < 3; ++dst){
+                if (dst == src || (top[dst] != 0 && top[dst] < disc) || !_rule(disc, src, dst, top[dst]))
+                    continue;
+
+                uint64_t moved = state + (uint64_t{ dst } - src) * _pow3[disc - 1];
+                if (claim(moved))
+                    out.push_back(moved);
+            }
+        }
+    }
+
+    size_t _towerLevels;
+    threadPool& _pool;
+    ruleT _rule;
+    uint64_t _pow3[maxLevels + 1] = {};
+    std::unique_ptr<std::atomic<uint64_t>[]> _visited;
+};
+
+#endif //HANOI_STATESEARCH_H
@@ -0,0 +1,69 @@
+#ifndef HANOI_TABLE_H
+#define HANOI_TABLE_H
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "moves.h"
+
+// Solutions for small fixed tower heights, generated and checked during compilation.
+// Every move is one byte, (src << 2) | dst, so a table lands in .rodata and solving is a lookup.
+
+constexpr size_t maxTableLevels = 16;
+
+constexpr uint8_t encodeMove(hanoiMove move){
+    return static_cast<uint8_t>(move.src << 2 | move.dst);
+}
+
+constexpr hanoiMove decodeMove(uint8_t code){
+    return { static_cast<uint8_t>(code >> 2), static_cast<uint8_t>(code & 3) };
+}
+
+template<size_t towerLevels>
+constexpr std::array<uint8_t, moveCount(towerLevels)> makeSolutionTable(){
+    static_assert(towerLevels >= 1 && towerLevels <= maxTableLevels, "Solution tables are meant for small towers only");
+
+    std::array<uint8_t, moveCount(towerLevels)> moves{};
+    for (uint64_t k = 0; k < moves.size(); ++k)
+        moves[k] = encodeMove(moveAt(k + 1, towerLevels));
+
+    return moves;
+}
+
+// Replays the moves on three occupancy masks, rejecting moves from an empty peg or onto a smaller disc.
+template<size_t movesCount>
+constexpr bool replaysToSolution(const std::array<uint8_t, movesCount>& moves, size_t towerLevels){
+    uint64_t masks[3] = { (uint64_t{ 1 } << towerLevels) - 1, 0, 0 };
+
+    for (auto code : moves){
+        auto [src, dst] = decodeMove(code);
+        if (src > 2 || dst > 2 || src == dst || masks[src] == 0)
+            return false;
+
+        auto disc = masks[src] & -masks[src];
+        if (masks[dst] != 0 && (masks[dst] & -masks[dst]) < disc)
+            return false;
+
+        masks[src] ^= disc;
+        masks[dst] ^= disc;
+    }
+
+    return masks[0] == 0 && masks[1] == 0;
+}
+
+template<size_t towerLevels>
+struct solutionTable{
+    static constexpr auto moves = makeSolutionTable<towerLevels>();
+    static_assert(replaysToSolution(moves, towerLevels), "Generated solution table does not solve the tower");
+};
+
+// Instantiates the table of every supported height, so each replay check runs in every build including this header.
+template<size_t... levels>
+constexpr bool allTablesBuilt(std::index_sequence<levels...>){
+    return ((solutionTable<levels + 1>::moves.size() == moveCount(levels + 1)) && ...);
+}
+
+static_assert(allTablesBuilt(std::make_index_sequence<maxTableLevels>{}));
+
+#endif //HANOI_TABLE_H
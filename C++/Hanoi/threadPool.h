@@ -0,0 +1,122 @@
+#ifndef HANOI_THREADPOOL_H
+#define HANOI_THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed set of workers fed from one task queue.
+class threadPool{
+public:
+    explicit threadPool(unsigned threads = 0){
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+
+        for (unsigned i = 0; i < threads; ++i)
+            _workers.emplace_back([this]{ workerLoop(); });
+    }
+
+    ~threadPool(){
+        {
+            std::lock_guard lock(_mutex);
+            _stop = true;
+        }
+        _cv.notify_all();
+
+        for (auto& worker : _workers)
+            worker.join();
+    }
+
+    threadPool(const threadPool&) = delete;
+    threadPool& operator=(const threadPool&) = delete;
+
+    [[nodiscard]] unsigned size() const { return static_cast<unsigned>(_workers.size()); }
+
+    void submit(std::function<void()> task){
+        {
+            std::lock_guard lock(_mutex);
+            _tasks.push(std::move(task));
+        }
+        _cv.notify_one();
+    }
+
+    // Runs body(i) for every i in [0, count), handing out chunks of grain indices to the workers
+    // and the calling thread. Returns once all are done and rethrows the first exception thrown.
+    template<class F>
+    void parallelFor(size_t count, F&& body, size_t grain = 256){
+        if (count == 0) return;
+
+        grain = std::max<size_t>(1, grain);
+        const size_t chunks = (count + grain - 1) / grain;
+        const size_t helpers = std::min<size_t>(size(), chunks - 1);
+
+        std::atomic<size_t> nextChunk{ 0 };
+        std::exception_ptr error;
+        std::mutex doneMutex;
+        std::condition_variable doneCv;
+        size_t running = helpers;
+
+        auto run = [&]() -> void
+        {
+            try {
+                for (size_t chunk; (chunk = nextChunk.fetch_add(1, std::memory_order_relaxed)) < chunks; ){
+                    size_t last = std::min(count, (chunk + 1) * grain);
+                    for (size_t i = chunk * grain; i < last; ++i)
+                        body(i);
+                }
+            }
+            catch (...) {
+                std::lock_guard lock(doneMutex);
+                if (!error) error = std::current_exception();
+                nextChunk = chunks;
+            }
+        };
+
+        for (size_t i = 0; i < helpers; ++i){
+            submit([&]{
+                run();
+
+                std::lock_guard lock(doneMutex);
+                if (--running == 0) doneCv.notify_one();
+            });
+        }
+
+        run();
+
+        std::unique_lock lock(doneMutex);
+        doneCv.wait(lock, [&]{ return running == 0; });
+
+        if (error) std::rethrow_exception(error);
+    }
+
+private:
+    void workerLoop(){
+        while (true){
+            std::function<void()> task;
+            {
+                std::unique_lock lock(_mutex);
+                _cv.wait(lock, [this]{ return _stop || !_tasks.empty(); });
+                if (_tasks.empty()) return;
+
+                task = std::move(_tasks.front());
+                _tasks.pop();
+            }
+
+            task();
+        }
+    }
+
+    std::vector<std::thread> _workers;
+    std::queue<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _stop = false;
+};
+
+#endif //HANOI_THREADPOOL_H
@@ -0,0 +1,66 @@
+#ifndef HANOI_TOWERS_H
+#define HANOI_TOWERS_H
+
+#include <array>
+#include <cstring>
+
+#include "stack.h"
+#include "state.h"
+
+// Default state backend: every peg is a stack of disc sizes, held by value.
+template<size_t towersCount = 3>
+class stackTowers{
+public:
+    using dtype = uint;
+    static const int count = towersCount;
+
+    explicit stackTowers(size_t towerLevels){
+        for(auto& tower : _towers){
+            tower = stack<dtype>(towerLevels);
+        }
+
+        for(dtype i = towerLevels; i > 0; --i)
+            _towers[0].push(i);
+    }
+
+    // Towers with disc d on peg pegs[d - 1].
+    explicit stackTowers(const towerConfig& pegs){
+        validatePegs(pegs, count);
+
+        for(auto& tower : _towers){
+            tower = stack<dtype>(pegs.size());
+        }
+
+        for(dtype i = pegs.size(); i > 0; --i)
+            _towers[pegs[i - 1]].push(i);
+    }
+
+    void move(size_t src, size_t dst){
+        auto elem = _towers[src].topNPop();
+        _towers[dst].push(elem);
+    }
+
+    // Whether moving the top disc of src onto dst is legal.
+    [[nodiscard]] bool canMove(size_t src, size_t dst) const{
+        if (_towers[src].isEmpty()) return false;
+
+        return _towers[dst].isEmpty() || _towers[src].top() < _towers[dst].top();
+    }
+
+    [[nodiscard]] size_t height(size_t tower) const{
+        return std::get<1>(_towers[tower].getUnderlyingData());
+    }
+
+    // Writes the discs of a tower bottom to top, returns how many were written.
+    size_t fillColumn(size_t tower, dtype* out) const{
+        auto [data, used] = _towers[tower].getUnderlyingData();
+        std::memcpy(out, data, used * sizeof(dtype));
+
+        return used;
+    }
+
+private:
+    std::array<stack<dtype>, count> _towers;
+};
+
+#endif //HANOI_TOWERS_H